@@ -0,0 +1,185 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ozone/media/nv12_to_rgba.h"
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#define NV12_TO_RGBA_USE_NEON
+#endif
+
+namespace media {
+
+namespace {
+
+// BT.601 limited range coefficients in 6-bit fixed point. The same values
+// are used by the scalar and the vectorized paths, so that all of them
+// produce identical output. Intermediate results fit in 16 bits except for
+// values far outside of [0, 255], which saturate and are clamped anyway.
+const int kYScale = 74;
+const int kVToR = 102;
+const int kUToG = 25;
+const int kVToG = 52;
+const int kUToB = 129;
+const int kRound = 32;
+const int kShift = 6;
+
+inline uint8 Clamp(int value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// Convert pixels [|begin|, |end|) of one row.
+void ConvertRow_C(const uint8* y_row,
+                  const uint8* uv_row,
+                  uint8* rgba_row,
+                  int begin,
+                  int end) {
+  for (int x = begin; x < end; ++x) {
+    int y = (y_row[x] - 16) * kYScale + kRound;
+    int u = uv_row[x & ~1] - 128;
+    int v = uv_row[(x & ~1) + 1] - 128;
+    uint8* pixel = rgba_row + 4 * x;
+    pixel[0] = Clamp((y + kVToR * v) >> kShift);
+    pixel[1] = Clamp((y - kUToG * u - kVToG * v) >> kShift);
+    pixel[2] = Clamp((y + kUToB * u) >> kShift);
+    pixel[3] = 255;
+  }
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// Convert 8 pixels per iteration and return the number of pixels converted.
+int ConvertRow_SSE2(const uint8* y_row,
+                    const uint8* uv_row,
+                    uint8* rgba_row,
+                    int width) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xff));
+  const __m128i low_mask = _mm_set1_epi32(0x0000ffff);
+  const __m128i high_mask = _mm_set1_epi32(0xffff0000);
+  const __m128i y_offset = _mm_set1_epi16(16);
+  const __m128i uv_offset = _mm_set1_epi16(128);
+  const __m128i round = _mm_set1_epi16(kRound);
+  const __m128i y_scale = _mm_set1_epi16(kYScale);
+  const __m128i v_to_r = _mm_set1_epi16(kVToR);
+  const __m128i u_to_g = _mm_set1_epi16(kUToG);
+  const __m128i v_to_g = _mm_set1_epi16(kVToG);
+  const __m128i u_to_b = _mm_set1_epi16(kUToB);
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i y = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y_row + x)), zero);
+    // Four interleaved UV pairs, one per two pixels. Spread them so that
+    // each 16-bit lane holds the chroma of its pixel.
+    __m128i uv = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv_row + x)), zero);
+    __m128i u = _mm_or_si128(_mm_and_si128(uv, low_mask),
+                             _mm_slli_epi32(uv, 16));
+    __m128i v = _mm_or_si128(_mm_srli_epi32(uv, 16),
+                             _mm_and_si128(uv, high_mask));
+
+    y = _mm_adds_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, y_offset), y_scale),
+                       round);
+    u = _mm_sub_epi16(u, uv_offset);
+    v = _mm_sub_epi16(v, uv_offset);
+
+    __m128i r = _mm_adds_epi16(y, _mm_mullo_epi16(v, v_to_r));
+    __m128i g = _mm_subs_epi16(
+        _mm_subs_epi16(y, _mm_mullo_epi16(u, u_to_g)),
+        _mm_mullo_epi16(v, v_to_g));
+    __m128i b = _mm_adds_epi16(y, _mm_mullo_epi16(u, u_to_b));
+
+    r = _mm_packus_epi16(_mm_srai_epi16(r, kShift), zero);
+    g = _mm_packus_epi16(_mm_srai_epi16(g, kShift), zero);
+    b = _mm_packus_epi16(_mm_srai_epi16(b, kShift), zero);
+
+    __m128i rg = _mm_unpacklo_epi8(r, g);
+    __m128i ba = _mm_unpacklo_epi8(b, alpha);
+    __m128i* out = reinterpret_cast<__m128i*>(rgba_row + 4 * x);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg, ba));
+  }
+  return x;
+}
+
+#elif defined(NV12_TO_RGBA_USE_NEON)
+
+inline uint8x8_t ToUint8_NEON(int16x8_t value) {
+  return vqmovun_s16(vshrq_n_s16(value, kShift));
+}
+
+// Convert 8 pixels with the chroma already spread one sample per pixel.
+inline void Convert8_NEON(uint8x8_t y_in,
+                          uint8x8_t u_in,
+                          uint8x8_t v_in,
+                          uint8* rgba) {
+  int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(y_in));
+  int16x8_t u = vreinterpretq_s16_u16(vmovl_u8(u_in));
+  int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(v_in));
+
+  y = vqaddq_s16(vmulq_n_s16(vsubq_s16(y, vdupq_n_s16(16)), kYScale),
+                 vdupq_n_s16(kRound));
+  u = vsubq_s16(u, vdupq_n_s16(128));
+  v = vsubq_s16(v, vdupq_n_s16(128));
+
+  uint8x8x4_t out;
+  out.val[0] = ToUint8_NEON(vqaddq_s16(y, vmulq_n_s16(v, kVToR)));
+  out.val[1] = ToUint8_NEON(vqsubq_s16(vqsubq_s16(y, vmulq_n_s16(u, kUToG)),
+                                       vmulq_n_s16(v, kVToG)));
+  out.val[2] = ToUint8_NEON(vqaddq_s16(y, vmulq_n_s16(u, kUToB)));
+  out.val[3] = vdup_n_u8(255);
+  vst4_u8(rgba, out);
+}
+
+// Convert 16 pixels per iteration and return the number of pixels converted.
+int ConvertRow_NEON(const uint8* y_row,
+                    const uint8* uv_row,
+                    uint8* rgba_row,
+                    int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16_t y = vld1q_u8(y_row + x);
+    uint8x8x2_t uv = vld2_u8(uv_row + x);
+    uint8x8x2_t u = vzip_u8(uv.val[0], uv.val[0]);
+    uint8x8x2_t v = vzip_u8(uv.val[1], uv.val[1]);
+    Convert8_NEON(vget_low_u8(y), u.val[0], v.val[0], rgba_row + 4 * x);
+    Convert8_NEON(vget_high_u8(y), u.val[1], v.val[1],
+                  rgba_row + 4 * (x + 8));
+  }
+  return x;
+}
+
+#endif
+
+}  // namespace
+
+void ConvertNV12ToRGBA(const uint8* y_plane,
+                       int y_stride,
+                       const uint8* uv_plane,
+                       int uv_stride,
+                       uint8* rgba,
+                       int rgba_stride,
+                       int width,
+                       int height) {
+  for (int row = 0; row < height; ++row) {
+    const uint8* y_row = y_plane + row * y_stride;
+    const uint8* uv_row = uv_plane + (row / 2) * uv_stride;
+    uint8* rgba_row = rgba + row * rgba_stride;
+
+    int converted = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+    converted = ConvertRow_SSE2(y_row, uv_row, rgba_row, width);
+#elif defined(NV12_TO_RGBA_USE_NEON)
+    converted = ConvertRow_NEON(y_row, uv_row, rgba_row, width);
+#endif
+    ConvertRow_C(y_row, uv_row, rgba_row, converted, width);
+  }
+}
+
+}  // namespace media
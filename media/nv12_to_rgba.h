@@ -0,0 +1,31 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// This file contains the NV12 to RGBA conversion used by
+// VaapiVideoDecodeAccelerator when the driver cannot convert decoded
+// surfaces into RGB images itself.
+
+#ifndef OZONE_MEDIA_NV12_TO_RGBA_H_
+#define OZONE_MEDIA_NV12_TO_RGBA_H_
+
+#include "base/basictypes.h"
+
+namespace media {
+
+// Convert a |width| x |height| NV12 image (BT.601, limited range) into
+// tightly packed or strided RGBA with opaque alpha. |y_plane| and |uv_plane|
+// may have arbitrary strides, so the conversion and the row repack happen in
+// a single pass. Uses SSE2 or NEON when available.
+void ConvertNV12ToRGBA(const uint8* y_plane,
+                       int y_stride,
+                       const uint8* uv_plane,
+                       int uv_stride,
+                       uint8* rgba,
+                       int rgba_stride,
+                       int width,
+                       int height);
+
+}  // namespace media
+
+#endif  // OZONE_MEDIA_NV12_TO_RGBA_H_
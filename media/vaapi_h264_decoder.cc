@@ -436,10 +436,9 @@ bool VaapiH264Decoder::SendVASliceParam(media::H264SliceHeader* slice_hdr) {
 }
 
 bool VaapiH264Decoder::SendSliceData(const uint8* ptr, size_t size) {
-  // Can't help it, blame libva...
-  void* non_const_ptr = const_cast<uint8*>(ptr);
-  return vaapi_wrapper_->SubmitBuffer(VASliceDataBufferType, size,
-                                      non_const_ptr);
+  // |ptr| points into the mapped input buffer, copy it into the HW decoder
+  // in one go.
+  return vaapi_wrapper_->SubmitSliceData(size, ptr);
 }
 
 bool VaapiH264Decoder::PrepareRefPicLists(media::H264SliceHeader* slice_hdr) {
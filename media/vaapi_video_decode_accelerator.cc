@@ -4,6 +4,9 @@
 
 #include "ozone/media/vaapi_video_decode_accelerator.h"
 
+#include <string.h>
+#include <sys/stat.h>
+
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
@@ -15,6 +18,8 @@
 #include "content/common/gpu/gpu_channel.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/video/picture.h"
+#include "ozone/media/nv12_to_rgba.h"
+#include "ui/gl/gl_implementation.h"
 #include "ui/gl/scoped_binders.h"
 #include "ui/gl/gl_surface_egl.h"
 
@@ -37,12 +42,28 @@ namespace media {
     }                                                               \
   } while (0)
 
-VaapiVideoDecodeAccelerator::InputBuffer::InputBuffer() : id(0), size(0) {
+// Maximum number of input buffer mappings kept around for reuse. Clients
+// normally cycle through a small set of shared memory regions.
+static const size_t kMaxFreeInputBuffers = 8;
+
+VaapiVideoDecodeAccelerator::InputBuffer::InputBuffer()
+    : id(0),
+      size(0),
+      recyclable(false),
+      shm_dev(0),
+      shm_ino(0) {
 }
 
 VaapiVideoDecodeAccelerator::InputBuffer::~InputBuffer() {
 }
 
+VaapiVideoDecodeAccelerator::Stats::Stats()
+    : input_queue_depth(0),
+      available_surfaces(0),
+      frames_output(0),
+      frames_dropped(0) {
+}
+
 void VaapiVideoDecodeAccelerator::NotifyError(Error error) {
   if (message_loop_ != base::MessageLoop::current()) {
     DCHECK(decoder_thread_proxy_->BelongsToCurrentThread());
@@ -78,7 +99,8 @@ class VaapiVideoDecodeAccelerator::TFPPicture : public base::NonThreadSafe {
       VaapiWrapper* va_wrapper,
       int32 picture_buffer_id,
       uint32 texture_id,
-      gfx::Size size);
+      gfx::Size size,
+      std::vector<uint8>* rgba_buffer);
 
   int32 picture_buffer_id() {
     return picture_buffer_id_;
@@ -96,10 +118,19 @@ class VaapiVideoDecodeAccelerator::TFPPicture : public base::NonThreadSafe {
              VaapiWrapper* va_wrapper,
              int32 picture_buffer_id,
              uint32 texture_id,
-             gfx::Size size);
+             gfx::Size size,
+             std::vector<uint8>* rgba_buffer);
 
   bool Initialize();
 
+  // Upload through |va_image_|, with the driver converting the surface to RGB.
+  // Sets |unsupported| if the driver cannot convert to RGB images at all.
+  bool UploadRGBImage(VASurfaceID surface, bool* unsupported);
+
+  // Upload by converting the NV12 contents of |surface| on the CPU, for
+  // drivers which cannot convert to RGB images.
+  bool UploadConvertedNV12(VASurfaceID surface);
+
   base::Callback<bool(void)> make_context_current_; //NOLINT
 
   VaapiWrapper* va_wrapper_;
@@ -109,7 +140,17 @@ class VaapiVideoDecodeAccelerator::TFPPicture : public base::NonThreadSafe {
   uint32 texture_id_;
 
   gfx::Size size_;
+
+  // Valid only while |has_rgb_image_| is true.
   VAImage va_image_;
+  bool has_rgb_image_;
+
+  // Whether GL_UNPACK_ROW_LENGTH can be used to upload strided images.
+  bool supports_unpack_row_length_;
+
+  // Scratch space for UploadConvertedNV12(), shared by all pictures and owned
+  // by the decoder.
+  std::vector<uint8>* rgba_buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(TFPPicture);
 };
@@ -119,13 +160,18 @@ VaapiVideoDecodeAccelerator::TFPPicture::TFPPicture(
     VaapiWrapper* va_wrapper,
     int32 picture_buffer_id,
     uint32 texture_id,
-    gfx::Size size)
+    gfx::Size size,
+    std::vector<uint8>* rgba_buffer)
     : make_context_current_(make_context_current),
       va_wrapper_(va_wrapper),
       picture_buffer_id_(picture_buffer_id),
       texture_id_(texture_id),
-      size_(size) {
+      size_(size),
+      has_rgb_image_(false),
+      supports_unpack_row_length_(false),
+      rgba_buffer_(rgba_buffer) {
   DCHECK(!make_context_current_.is_null());
+  DCHECK(rgba_buffer_);
 };
 
 linked_ptr<VaapiVideoDecodeAccelerator::TFPPicture>
@@ -134,10 +180,11 @@ VaapiVideoDecodeAccelerator::TFPPicture::Create(
     VaapiWrapper* va_wrapper,
     int32 picture_buffer_id,
     uint32 texture_id,
-    gfx::Size size) {
+    gfx::Size size,
+    std::vector<uint8>* rgba_buffer) {
   linked_ptr<TFPPicture> tfp_picture(
       new TFPPicture(make_context_current, va_wrapper,
-                     picture_buffer_id, texture_id, size));
+                     picture_buffer_id, texture_id, size, rgba_buffer));
 
   if (!tfp_picture->Initialize())
     tfp_picture.reset();
@@ -150,29 +197,63 @@ bool VaapiVideoDecodeAccelerator::TFPPicture::Initialize() {
   if (!make_context_current_.Run())
     return false;
 
-  if (!va_wrapper_->CreateRGBImage(size_, &va_image_)) {
-    DVLOG(1) << "Failed to create VAImage";
-    return false;
+  if (gfx::GetGLImplementation() == gfx::kGLImplementationDesktopGL) {
+    supports_unpack_row_length_ = true;
+  } else {
+    const char* extensions =
+        reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    supports_unpack_row_length_ =
+        extensions && strstr(extensions, "GL_EXT_unpack_subimage");
   }
 
+  has_rgb_image_ = va_wrapper_->CreateRGBImage(size_, &va_image_);
+  if (!has_rgb_image_)
+    DVLOG(1) << "Failed to create VAImage, converting on CPU instead";
+
   return true;
 }
 
 VaapiVideoDecodeAccelerator::TFPPicture::~TFPPicture() {
   DCHECK(CalledOnValidThread());
 
-  if (va_wrapper_) {
+  if (va_wrapper_ && has_rgb_image_) {
     va_wrapper_->DestroyImage(&va_image_);
   }
 }
 
 bool VaapiVideoDecodeAccelerator::TFPPicture::Upload(VASurfaceID surface) {
   DCHECK(CalledOnValidThread());
+  TRACE_EVENT1("Video Decoder", "TFPPicture::Upload",
+               "picture_buffer_id", picture_buffer_id_);
 
   if (!make_context_current_.Run())
     return false;
 
-  if (!va_wrapper_->PutSurfaceIntoImage(surface, &va_image_)) {
+  gfx::ScopedTextureBinder texture_binder(GL_TEXTURE_2D, texture_id_);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+  if (has_rgb_image_) {
+    bool unsupported = false;
+    if (UploadRGBImage(surface, &unsupported))
+      return true;
+
+    // Some drivers cannot convert to RGB at all, stop trying. Other failures
+    // may be specific to this surface, convert it on CPU and try the image
+    // again for the next one.
+    if (unsupported) {
+      DVLOG(1) << "Falling back to converting surfaces on CPU";
+      va_wrapper_->DestroyImage(&va_image_);
+      has_rgb_image_ = false;
+    }
+  }
+
+  return UploadConvertedNV12(surface);
+}
+
+bool VaapiVideoDecodeAccelerator::TFPPicture::UploadRGBImage(
+    VASurfaceID surface, bool* unsupported) {
+  if (!va_wrapper_->PutSurfaceIntoImage(surface, &va_image_, unsupported)) {
     DVLOG(1) << "Failed to put va surface to image";
     return false;
   }
@@ -183,32 +264,69 @@ bool VaapiVideoDecodeAccelerator::TFPPicture::Upload(VASurfaceID surface) {
     return false;
   }
 
-  gfx::ScopedTextureBinder texture_binder(GL_TEXTURE_2D, texture_id_);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-
   // See bug https://crosswalk-project.org/jira/browse/XWALK-2265.
-  // The following small piece of code is a workaround for the current VDA
-  // texture output implementation. It can be removed when zero buffer copy
-  // is implemented.
+  // Rows of the image may be padded for special video sizes. Let GL skip the
+  // padding where it can, otherwise realign the rows in place.
   unsigned int al = 4 * size_.width();
-  if (al != va_image_.pitches[0]) {
-    // Not aligned phenomenon occurs only in special size video in None-X11.
-    // So re-check RGBA data alignment and realign filled video frame in need.
-    unsigned char* bhandle = static_cast<unsigned char*>(buffer);
-    for (int i = 0; i < size_.height(); i++) {
-      memcpy(bhandle + (i * al), bhandle + (i * (va_image_.pitches[0])), al);
+  unsigned int pitch = va_image_.pitches[0];
+  bool set_row_length = false;
+  if (al != pitch) {
+    if (supports_unpack_row_length_ && pitch % 4 == 0) {
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / 4);
+      set_row_length = true;
+    } else {
+      unsigned char* bhandle = static_cast<unsigned char*>(buffer);
+      for (int i = 1; i < size_.height(); i++)
+        memmove(bhandle + (i * al), bhandle + (i * pitch), al);
     }
   }
 
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size_.width(), size_.height(),
                0, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
 
+  if (set_row_length)
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
   va_wrapper_->UnmapImage(&va_image_);
 
   return true;
 }
 
+bool VaapiVideoDecodeAccelerator::TFPPicture::UploadConvertedNV12(
+    VASurfaceID surface) {
+  TRACE_EVENT0("Video Decoder", "TFPPicture::UploadConvertedNV12");
+
+  VAImage image;
+  void* buffer = NULL;
+  if (!va_wrapper_->DeriveAndMapImage(surface, &image, &buffer)) {
+    DVLOG(1) << "Failed to derive image from va surface";
+    return false;
+  }
+
+  if (image.format.fourcc != VA_FOURCC_NV12 ||
+      image.width < size_.width() || image.height < size_.height()) {
+    DVLOG(1) << "Unsupported derived image format " << image.format.fourcc;
+    va_wrapper_->ReleaseDerivedImage(&image);
+    return false;
+  }
+
+  size_t rgba_size = 4 * size_.GetArea();
+  if (rgba_buffer_->size() < rgba_size)
+    rgba_buffer_->resize(rgba_size);
+
+  const uint8* data = static_cast<const uint8*>(buffer);
+  ConvertNV12ToRGBA(data + image.offsets[0], image.pitches[0],
+                    data + image.offsets[1], image.pitches[1],
+                    &(*rgba_buffer_)[0], 4 * size_.width(),
+                    size_.width(), size_.height());
+  va_wrapper_->ReleaseDerivedImage(&image);
+
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size_.width(), size_.height(),
+               0, GL_RGBA, GL_UNSIGNED_BYTE, &(*rgba_buffer_)[0]);
+
+  return true;
+}
+
 VaapiVideoDecodeAccelerator::TFPPicture*
     VaapiVideoDecodeAccelerator::TFPPictureById(int32 picture_buffer_id) {
   TFPPictures::iterator it = tfp_pictures_.find(picture_buffer_id);
@@ -262,6 +380,8 @@ bool VaapiVideoDecodeAccelerator::Initialize(media::VideoCodecProfile profile,
       gfx::GLSurfaceEGL::GetNativeDisplay(),
       base::Bind(&ReportToUMA, VaapiH264Decoder::VAAPI_ERROR));
 
+  // This also fails when the maximum number of hardware decode sessions is
+  // reached; the client then falls back to software decode for this stream.
   if (!vaapi_wrapper_.get()) {
     DVLOG(1) << "Failed initializing VAAPI";
     return false;
@@ -289,8 +409,12 @@ void VaapiVideoDecodeAccelerator::SurfaceReady(
   DCHECK(!awaiting_va_surfaces_recycle_);
 
   // Drop any requests to output if we are resetting or being destroyed.
-  if (state_ == kResetting || state_ == kDestroying)
+  if (state_ == kResetting || state_ == kDestroying) {
+    base::AutoLock auto_lock(lock_);
+    ++stats_.frames_dropped;
+    TRACE_COUNTER1("Video Decoder", "Dropped frames", stats_.frames_dropped);
     return;
+  }
 
   pending_output_cbs_.push(
       base::Bind(&VaapiVideoDecodeAccelerator::OutputPicture,
@@ -314,10 +438,17 @@ void VaapiVideoDecodeAccelerator::OutputPicture(
   DVLOG(3) << "Outputting VASurface " << va_surface->id()
            << " into pixmap bound to picture buffer id " << output_id;
 
+  base::TimeTicks upload_start = base::TimeTicks::Now();
   RETURN_AND_NOTIFY_ON_FAILURE(tfp_picture->Upload(va_surface->id()),
                                "Failed to upload VASurface to texture",
                                PLATFORM_FAILURE, ); //NOLINT
 
+  {
+    base::AutoLock auto_lock(lock_);
+    stats_.upload_time += base::TimeTicks::Now() - upload_start;
+    ++stats_.frames_output;
+  }
+
   // Notify the client a picture is ready to be displayed.
   ++num_frames_at_client_;
   TRACE_COUNTER1("Video Decoder", "Textures at client", num_frames_at_client_);
@@ -359,16 +490,50 @@ void VaapiVideoDecodeAccelerator::MapAndQueueNewInputBuffer(
   DVLOG(4) << "Mapping new input buffer id: " << bitstream_buffer.id()
            << " size: " << static_cast<int>(bitstream_buffer.size());
 
-  scoped_ptr<base::SharedMemory> shm(
-      new base::SharedMemory(bitstream_buffer.handle(), true));
-  RETURN_AND_NOTIFY_ON_FAILURE(shm->Map(bitstream_buffer.size()),
-      "Failed to map input buffer", UNREADABLE_INPUT,); //NOLINT
+  struct stat shm_stat;
+  bool recyclable = fstat(bitstream_buffer.handle().fd, &shm_stat) == 0;
+
+  // Look for an existing mapping of the same shared memory region first.
+  linked_ptr<InputBuffer> input_buffer;
+  if (recyclable) {
+    base::AutoLock auto_lock(lock_);
+    for (std::list<linked_ptr<InputBuffer> >::iterator it =
+             free_input_buffers_.begin();
+         it != free_input_buffers_.end(); ++it) {
+      if ((*it)->shm_dev == shm_stat.st_dev &&
+          (*it)->shm_ino == shm_stat.st_ino &&
+          (*it)->shm->mapped_size() >= bitstream_buffer.size()) {
+        input_buffer = *it;
+        free_input_buffers_.erase(it);
+        break;
+      }
+    }
+  }
+
+  if (input_buffer.get()) {
+    DVLOG(4) << "Reusing mapping for input buffer id: "
+             << bitstream_buffer.id();
+    base::SharedMemory::CloseHandle(bitstream_buffer.handle());
+  } else {
+    scoped_ptr<base::SharedMemory> shm(
+        new base::SharedMemory(bitstream_buffer.handle(), true));
+    RETURN_AND_NOTIFY_ON_FAILURE(shm->Map(bitstream_buffer.size()),
+        "Failed to map input buffer", UNREADABLE_INPUT,); //NOLINT
+    // The mapping stays valid without the handle.
+    shm->Close();
+
+    input_buffer.reset(new InputBuffer());
+    input_buffer->shm.reset(shm.release());
+    input_buffer->recyclable = recyclable;
+    if (recyclable) {
+      input_buffer->shm_dev = shm_stat.st_dev;
+      input_buffer->shm_ino = shm_stat.st_ino;
+    }
+  }
 
   base::AutoLock auto_lock(lock_);
 
-  // Set up a new input buffer and queue it for later.
-  linked_ptr<InputBuffer> input_buffer(new InputBuffer());
-  input_buffer->shm.reset(shm.release());
+  // Set up the input buffer and queue it for later.
   input_buffer->id = bitstream_buffer.id();
   input_buffer->size = bitstream_buffer.size();
 
@@ -377,6 +542,8 @@ void VaapiVideoDecodeAccelerator::MapAndQueueNewInputBuffer(
                  num_stream_bufs_at_decoder_);
 
   input_buffers_.push(input_buffer);
+  TRACE_COUNTER1("Video Decoder", "Input buffers queued",
+                 input_buffers_.size());
   input_ready_.Signal();
 }
 
@@ -408,6 +575,8 @@ bool VaapiVideoDecodeAccelerator::GetInputBuffer_Locked() {
 
       curr_input_buffer_ = input_buffers_.front();
       input_buffers_.pop();
+      TRACE_COUNTER1("Video Decoder", "Input buffers queued",
+                     input_buffers_.size());
 
       DVLOG(4) << "New current bitstream buffer, id: "
                << curr_input_buffer_->id
@@ -431,6 +600,7 @@ void VaapiVideoDecodeAccelerator::ReturnCurrInputBuffer_Locked() {
   DCHECK(curr_input_buffer_.get());
 
   int32 id = curr_input_buffer_->id;
+  RecycleInputBuffer_Locked(curr_input_buffer_);
   curr_input_buffer_.reset();
   DVLOG(4) << "End of input buffer " << id;
   message_loop_->PostTask(FROM_HERE, base::Bind(
@@ -441,6 +611,18 @@ void VaapiVideoDecodeAccelerator::ReturnCurrInputBuffer_Locked() {
                  num_stream_bufs_at_decoder_);
 }
 
+void VaapiVideoDecodeAccelerator::RecycleInputBuffer_Locked(
+    const linked_ptr<InputBuffer>& input_buffer) {
+  lock_.AssertAcquired();
+
+  if (!input_buffer->recyclable)
+    return;
+
+  free_input_buffers_.push_front(input_buffer);
+  if (free_input_buffers_.size() > kMaxFreeInputBuffers)
+    free_input_buffers_.pop_back();
+}
+
 bool VaapiVideoDecodeAccelerator::FeedDecoderWithOutputSurfaces_Locked() {
   lock_.AssertAcquired();
   DCHECK(decoder_thread_proxy_->BelongsToCurrentThread());
@@ -459,6 +641,7 @@ bool VaapiVideoDecodeAccelerator::FeedDecoderWithOutputSurfaces_Locked() {
     available_va_surfaces_.pop_front();
     decoder_->ReuseSurface(va_surface);
   }
+  TRACE_COUNTER1("Video Decoder", "Available VA surfaces", 0);
 
   return true;
 }
@@ -480,6 +663,7 @@ void VaapiVideoDecodeAccelerator::DecodeTask() {
     DCHECK(curr_input_buffer_.get());
 
     VaapiH264Decoder::DecResult res;
+    base::TimeTicks decode_start = base::TimeTicks::Now();
     {
       // We are OK releasing the lock here, as decoder never calls our methods
       // directly and we will reacquire the lock before looking at state again.
@@ -489,6 +673,7 @@ void VaapiVideoDecodeAccelerator::DecodeTask() {
       base::AutoUnlock auto_unlock(lock_);
       res = decoder_->Decode();
     }
+    stats_.decode_task_time += base::TimeTicks::Now() - decode_start;
 
     switch (res) {
       case VaapiH264Decoder::kAllocateNewSurfaces:
@@ -623,6 +808,8 @@ void VaapiVideoDecodeAccelerator::RecycleVASurfaceID(
   base::AutoLock auto_lock(lock_);
 
   available_va_surfaces_.push_back(va_surface_id);
+  TRACE_COUNTER1("Video Decoder", "Available VA surfaces",
+                 available_va_surfaces_.size());
   surfaces_available_.Signal();
 }
 
@@ -643,11 +830,20 @@ void VaapiVideoDecodeAccelerator::AssignPictureBuffers(
   DCHECK(requested_pic_size_ == buffers[0].size());
 
   std::vector<VASurfaceID> va_surface_ids;
-  RETURN_AND_NOTIFY_ON_FAILURE(
-      vaapi_wrapper_->CreateSurfaces(requested_pic_size_,
-                                     buffers.size(),
-                                     &va_surface_ids),
-      "Failed creating VA Surfaces", PLATFORM_FAILURE,); //NOLINT
+  if (!vaapi_wrapper_->CreateSurfaces(requested_pic_size_,
+                                      buffers.size(),
+                                      &va_surface_ids)) {
+    // The stream can't switch to software decode anymore. If other sessions
+    // hold the hardware resources, try again once one of them ends.
+    if (vaapi_wrapper_->WaitForResources(media::BindToCurrentLoop(base::Bind(
+            &VaapiVideoDecodeAccelerator::AssignPictureBuffers, weak_this_,
+            buffers)))) {
+      DVLOG(1) << "Out of decode resources, waiting for another session";
+      return;
+    }
+    RETURN_AND_NOTIFY_ON_FAILURE(false, "Failed creating VA Surfaces",
+                                 PLATFORM_FAILURE,); //NOLINT
+  }
   DCHECK_EQ(va_surface_ids.size(), buffers.size());
 
   for (size_t i = 0; i < buffers.size(); ++i) {
@@ -660,7 +856,8 @@ void VaapiVideoDecodeAccelerator::AssignPictureBuffers(
                            vaapi_wrapper_.get(),
                            buffers[i].id(),
                            buffers[i].texture_id(),
-                           requested_pic_size_));
+                           requested_pic_size_,
+                           &rgba_buffer_));
 
     RETURN_AND_NOTIFY_ON_FAILURE(
         tfp_picture.get(), "Failed assigning picture buffer to a texture.",
@@ -783,8 +980,10 @@ void VaapiVideoDecodeAccelerator::Reset() {
     message_loop_->PostTask(FROM_HERE, base::Bind(
         &Client::NotifyEndOfBitstreamBuffer, client_,
         input_buffers_.front()->id));
+    RecycleInputBuffer_Locked(input_buffers_.front());
     input_buffers_.pop();
   }
+  TRACE_COUNTER1("Video Decoder", "Input buffers queued", 0);
 
   decoder_thread_proxy_->PostTask(FROM_HERE, base::Bind(
       &VaapiVideoDecodeAccelerator::ResetTask, base::Unretained(this)));
@@ -804,6 +1003,8 @@ void VaapiVideoDecodeAccelerator::FinishReset() {
   }
 
   // Drop pending outputs.
+  stats_.frames_dropped += pending_output_cbs_.size();
+  TRACE_COUNTER1("Video Decoder", "Dropped frames", stats_.frames_dropped);
   while (!pending_output_cbs_.empty())
     pending_output_cbs_.pop();
 
@@ -845,6 +1046,7 @@ void VaapiVideoDecodeAccelerator::Cleanup() {
     return;
 
   DVLOG(1) << "Destroying VAVDA";
+  LogStats();
   base::AutoLock auto_lock(lock_);
   state_ = kDestroying;
 
@@ -876,4 +1078,32 @@ bool VaapiVideoDecodeAccelerator::CanDecodeOnIOThread() {
   return false;
 }
 
+void VaapiVideoDecodeAccelerator::GetStats(Stats* stats) {
+  DCHECK_EQ(message_loop_, base::MessageLoop::current());
+  DCHECK(stats);
+
+  {
+    base::AutoLock auto_lock(lock_);
+    *stats = stats_;
+    stats->input_queue_depth = input_buffers_.size();
+    stats->available_surfaces = available_va_surfaces_.size();
+  }
+
+  if (vaapi_wrapper_) {
+    vaapi_wrapper_->GetDriverTimings(&stats->submit_decode_time,
+                                     &stats->surface_sync_time);
+  }
+}
+
+void VaapiVideoDecodeAccelerator::LogStats() {
+  Stats stats;
+  GetStats(&stats);
+  DVLOG(1) << "Frames output: " << stats.frames_output
+           << ", dropped: " << stats.frames_dropped
+           << ", decode: " << stats.decode_task_time.InMilliseconds() << "ms"
+           << ", submit: " << stats.submit_decode_time.InMilliseconds() << "ms"
+           << ", sync: " << stats.surface_sync_time.InMilliseconds() << "ms"
+           << ", upload: " << stats.upload_time.InMilliseconds() << "ms";
+}
+
 }  // namespace media
@@ -8,6 +8,8 @@
 #ifndef OZONE_MEDIA_VAAPI_VIDEO_DECODE_ACCELERATOR_H_
 #define OZONE_MEDIA_VAAPI_VIDEO_DECODE_ACCELERATOR_H_
 
+#include <sys/types.h>
+
 #include <list>
 #include <map>
 #include <queue>
@@ -23,6 +25,7 @@
 #include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "media/base/bitstream_buffer.h"
 #include "media/video/picture.h"
@@ -60,6 +63,35 @@ class VaapiVideoDecodeAccelerator
   virtual void Destroy() OVERRIDE;
   virtual bool CanDecodeOnIOThread() OVERRIDE;
 
+  // Snapshot of the decoder instrumentation. Times are accumulated since
+  // Initialize(), queue depths reflect the state at the time of the query.
+  // The same values are also emitted as trace events and counters under the
+  // "Video Decoder" category.
+  struct Stats {
+    Stats();
+
+    // Bitstream buffers queued in |input_buffers_|, not yet at the decoder.
+    size_t input_queue_depth;
+    // VASurfaces in |available_va_surfaces_|, ready to be decoded into.
+    size_t available_surfaces;
+    // Pictures handed to the client via PictureReady().
+    int frames_output;
+    // Decoded pictures discarded before output (on reset or destroy).
+    int frames_dropped;
+    // Time spent in the decoder proper, on the decoder thread.
+    base::TimeDelta decode_task_time;
+    // Time spent submitting decode jobs to the driver.
+    base::TimeDelta submit_decode_time;
+    // Time spent waiting in the driver for surfaces to be decoded.
+    base::TimeDelta surface_sync_time;
+    // Time spent in TFPPicture::Upload(), including the surface sync.
+    base::TimeDelta upload_time;
+  };
+
+  // Fill |stats| with the current instrumentation values. Must be called on
+  // the GPU ChildThread.
+  void GetStats(Stats* stats);
+
 private:
   // Notify the client that an error has occurred and decoding cannot continue.
   void NotifyError(Error error);
@@ -76,9 +108,14 @@ private:
   bool GetInputBuffer_Locked();
 
   // Signal the client that the current buffer has been read and can be
-  // returned. Will also release the mapping.
+  // returned. Its mapping is kept for reuse, see RecycleInputBuffer_Locked().
   void ReturnCurrInputBuffer_Locked();
 
+  // Keep the mapping of |input_buffer|, which has been returned to the
+  // client, so that it can be reused if the client sends a bitstream buffer
+  // backed by the same shared memory region again.
+  void RecycleInputBuffer_Locked(const linked_ptr<InputBuffer>& input_buffer);
+
   // Pass one or more output buffers to the decoder. This will sleep
   // if no buffers are available. Return true if buffers have been set up or
   // false if an early exit has been requested (due to initiated
@@ -115,6 +152,9 @@ private:
   // Helper for Destroy(), doing all the actual work except for deleting self.
   void Cleanup();
 
+  // Logs the instrumentation of the decode session, see GetStats().
+  void LogStats();
+
   // Get a usable framebuffer configuration for use in binding textures
   // or return false on failure.
   bool InitializeFBConfig();
@@ -178,6 +218,12 @@ private:
     int32 id;
     size_t size;
     scoped_ptr<base::SharedMemory> shm;
+
+    // Identity of the shared memory region mapped in |shm|. Only valid if
+    // |recyclable| is true.
+    bool recyclable;
+    dev_t shm_dev;
+    ino_t shm_ino;
   };
 
   // Queue for incoming input buffers.
@@ -189,6 +235,10 @@ private:
   // Current input buffer at decoder.
   linked_ptr<InputBuffer> curr_input_buffer_;
 
+  // Input buffers already returned to the client whose mappings are kept for
+  // reuse, most recently returned first.
+  std::list<linked_ptr<InputBuffer> > free_input_buffers_;
+
   // Queue for incoming output buffers (texture ids).
   typedef std::queue<int32> OutputBuffers;
   OutputBuffers output_buffers_;
@@ -201,6 +251,10 @@ private:
   // Return a TFPPicture associated with given client-provided id.
   TFPPicture* TFPPictureById(int32 picture_buffer_id);
 
+  // RGBA frame for TFPPictures converting surfaces on CPU, only one of them
+  // uploads at a time. Grown on first use.
+  std::vector<uint8> rgba_buffer_;
+
   // VA Surfaces no longer in use that can be passed back to the decoder for
   // reuse, once it requests them.
   std::list<VASurfaceID> available_va_surfaces_;
@@ -265,6 +319,10 @@ private:
   size_t requested_num_pics_;
   gfx::Size requested_pic_size_;
 
+  // Instrumentation, see GetStats(). Protected by lock_. The driver timings
+  // are kept by VaapiWrapper and filled in on query.
+  Stats stats_;
+
   // The WeakPtrFactory for |weak_this_|.
   base::WeakPtrFactory<VaapiVideoDecodeAccelerator> weak_this_factory_;
 
@@ -5,10 +5,13 @@
 #include "vaapi_wrapper.h"
 
 #include <dlfcn.h>
+#include <string.h>
+#include <algorithm>
 // XXX
 #include <wayland-client.h>
 
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
 // Auto-generated for dlopen libva libraries
@@ -46,6 +49,190 @@ static const base::FilePath::CharType kVaLib[] =
 
 namespace media {
 
+// Slice data buffers are allocated in power of two sizes, starting at
+// kMinSliceDataBufferSize, so that they can be reused by slices of
+// varying size.
+static const size_t kMinSliceDataBufferSize = 64 * 1024;
+
+// Maximum number of idle slice data buffers kept in the pool.
+static const size_t kMaxFreeSliceDataBuffers = 16;
+
+// Default maximum number of concurrent decode sessions. Lowered at runtime
+// if the driver runs out of resources with fewer sessions, and raised back
+// as sessions end and free their resources.
+static const int kMaxDecodeSessions = 4;
+
+// Reference counted VADisplay connection shared by all VaapiWrappers, along
+// with the lock serializing access to it and the session admission state.
+class VaapiWrapper::VADisplayState {
+ public:
+  VADisplayState();
+  ~VADisplayState();
+
+  // Take a reference to the display, connecting to |display| and
+  // initializing libva if this is the first one. No reference is taken on
+  // failure. |va_lock_| must be held.
+  bool Initialize(void* display);
+
+  // Drop a reference, terminating the connection with the last one.
+  // |va_lock_| must be held.
+  void Deinitialize();
+
+  // Try to start a new decode session. Returns false if the maximum number
+  // of sessions is already running. |va_lock_| must be held.
+  bool AdmitSession();
+
+  // End a session started with AdmitSession(), moving the callbacks waiting
+  // for it into |release_cbs|, to be run once |va_lock_| is released.
+  // |va_lock_| must be held.
+  void ReleaseSession(std::vector<base::Closure>* release_cbs);
+
+  // Called when the driver fails to allocate resources for a session, to
+  // stop admitting more sessions than currently running. |va_lock_| must be
+  // held.
+  void OnSessionResourcesExhausted();
+
+  // Have |release_cb| run when the next session ends. Returns false if no
+  // other session than the caller's is running. |va_lock_| must be held.
+  bool AddReleaseCallback(const base::Closure& release_cb);
+
+  base::Lock* va_lock() { return &va_lock_; }
+  VADisplay va_display() const { return va_display_; }
+  int major_version() const { return major_version_; }
+  int minor_version() const { return minor_version_; }
+
+ private:
+  base::Lock va_lock_;
+
+  // Number of VaapiWrappers referencing |va_display_|.
+  int refcount_;
+
+  VADisplay va_display_;
+  int major_version_;
+  int minor_version_;
+
+  int active_sessions_;
+  int max_sessions_;
+
+  // Sessions waiting for resources held by others, see AddReleaseCallback().
+  std::vector<base::Closure> release_cbs_;
+
+  DISALLOW_COPY_AND_ASSIGN(VADisplayState);
+};
+
+// static
+base::LazyInstance<VaapiWrapper::VADisplayState>::Leaky
+    VaapiWrapper::va_display_state_ = LAZY_INSTANCE_INITIALIZER;
+
+VaapiWrapper::VADisplayState::VADisplayState()
+    : refcount_(0),
+      va_display_(NULL),
+      major_version_(0),
+      minor_version_(0),
+      active_sessions_(0),
+      max_sessions_(kMaxDecodeSessions) {
+}
+
+VaapiWrapper::VADisplayState::~VADisplayState() {
+}
+
+bool VaapiWrapper::VADisplayState::Initialize(void* display) {
+  va_lock_.AssertAcquired();
+
+  if (refcount_ > 0) {
+    ++refcount_;
+    return true;
+  }
+
+  va_display_ = vaGetDisplayWl(static_cast<wl_display *>(display));
+  if (!vaDisplayIsValid(va_display_)) {
+    DVLOG(1) << "Could not get a valid VA display";
+    va_display_ = NULL;
+    return false;
+  }
+
+  VAStatus va_res = vaInitialize(va_display_, &major_version_,
+                                 &minor_version_);
+  if (va_res != VA_STATUS_SUCCESS) {
+    DVLOG(1) << "vaInitialize failed: " << vaErrorStr(va_res);
+    va_display_ = NULL;
+    return false;
+  }
+
+  DVLOG(1) << "VAAPI version: " << major_version_ << "." << minor_version_;
+  refcount_ = 1;
+  return true;
+}
+
+void VaapiWrapper::VADisplayState::Deinitialize() {
+  va_lock_.AssertAcquired();
+  DCHECK_GT(refcount_, 0);
+
+  if (--refcount_ > 0)
+    return;
+
+  if (va_display_) {
+    VAStatus va_res = vaTerminate(va_display_);
+    if (va_res != VA_STATUS_SUCCESS)
+      DVLOG(1) << "vaTerminate failed: " << vaErrorStr(va_res);
+  }
+
+  va_display_ = NULL;
+}
+
+bool VaapiWrapper::VADisplayState::AdmitSession() {
+  va_lock_.AssertAcquired();
+
+  if (active_sessions_ >= max_sessions_) {
+    DVLOG(1) << "Refusing decode session, " << active_sessions_
+             << " already running";
+    return false;
+  }
+
+  ++active_sessions_;
+  TRACE_COUNTER1("Video Decoder", "VA decode sessions", active_sessions_);
+  return true;
+}
+
+void VaapiWrapper::VADisplayState::ReleaseSession(
+    std::vector<base::Closure>* release_cbs) {
+  va_lock_.AssertAcquired();
+  DCHECK_GT(active_sessions_, 0);
+
+  --active_sessions_;
+  TRACE_COUNTER1("Video Decoder", "VA decode sessions", active_sessions_);
+
+  // The resources of the session are free again, so let the limit recover
+  // one step at a time. Running out again lowers it again.
+  if (max_sessions_ < kMaxDecodeSessions) {
+    ++max_sessions_;
+    DVLOG(1) << "Raising concurrent decode session limit to " << max_sessions_;
+  }
+
+  release_cbs->swap(release_cbs_);
+}
+
+void VaapiWrapper::VADisplayState::OnSessionResourcesExhausted() {
+  va_lock_.AssertAcquired();
+
+  int limit = std::max(active_sessions_ - 1, 1);
+  if (limit < max_sessions_) {
+    DVLOG(1) << "Limiting concurrent decode sessions to " << limit;
+    max_sessions_ = limit;
+  }
+}
+
+bool VaapiWrapper::VADisplayState::AddReleaseCallback(
+    const base::Closure& release_cb) {
+  va_lock_.AssertAcquired();
+
+  if (active_sessions_ <= 1)
+    return false;
+
+  release_cbs_.push_back(release_cb);
+  return true;
+}
+
 // Maps Profile enum values to VaProfile values.
 static VAProfile ProfileToVAProfile(
     media::VideoCodecProfile profile,
@@ -102,7 +289,11 @@ VASurface::~VASurface() {
 }
 
 VaapiWrapper::VaapiWrapper()
-    : va_display_(NULL),
+    : va_lock_(va_display_state_.Get().va_lock()),
+      display_initialized_(false),
+      session_admitted_(false),
+      resources_exhausted_(false),
+      va_display_(NULL),
       va_config_id_(VA_INVALID_ID),
       va_context_id_(VA_INVALID_ID) {
 }
@@ -148,30 +339,33 @@ bool VaapiWrapper::Initialize(media::VideoCodecProfile profile,
 
   report_error_to_uma_cb_ = report_error_to_uma_cb;
 
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
 
-  va_display_ = vaGetDisplayWl(static_cast<wl_display *>(display));
-  if (!vaDisplayIsValid(va_display_)) {
-    DVLOG(1) << "Could not get a valid VA display";
+  VADisplayState* display_state = va_display_state_.Pointer();
+  display_initialized_ = display_state->Initialize(display);
+  if (!display_initialized_)
     return false;
-  }
 
-  VAStatus va_res = vaInitialize(va_display_, &major_version_, &minor_version_);
-  VA_SUCCESS_OR_RETURN(va_res, "vaInitialize failed", false);
-  DVLOG(1) << "VAAPI version: " << major_version_ << "." << minor_version_;
+  va_display_ = display_state->va_display();
+  major_version_ = display_state->major_version();
+  minor_version_ = display_state->minor_version();
 
   if (VAAPIVersionLessThan(0, 34)) {
     DVLOG(1) << "VAAPI version < 0.34 is not supported.";
     return false;
   }
 
+  session_admitted_ = display_state->AdmitSession();
+  if (!session_admitted_)
+    return false;
+
   // Query the driver for supported profiles.
   int max_profiles = vaMaxNumProfiles(va_display_);
   std::vector<VAProfile> supported_profiles(
       base::checked_cast<size_t>(max_profiles));
 
   int num_supported_profiles;
-  va_res = vaQueryConfigProfiles(
+  VAStatus va_res = vaQueryConfigProfiles(
       va_display_, &supported_profiles[0], &num_supported_profiles);
   VA_SUCCESS_OR_RETURN(va_res, "vaQueryConfigProfiles failed", false);
   if (num_supported_profiles < 0 || num_supported_profiles > max_profiles) {
@@ -208,20 +402,39 @@ bool VaapiWrapper::Initialize(media::VideoCodecProfile profile,
 }
 
 void VaapiWrapper::Deinitialize() {
-  base::AutoLock auto_lock(va_lock_);
+  std::vector<base::Closure> release_cbs;
+  {
+    base::AutoLock auto_lock(*va_lock_);
 
-  if (va_config_id_ != VA_INVALID_ID) {
-    VAStatus va_res = vaDestroyConfig(va_display_, va_config_id_);
-    VA_LOG_ON_ERROR(va_res, "vaDestroyConfig failed");
-  }
+    if (va_config_id_ != VA_INVALID_ID) {
+      VAStatus va_res = vaDestroyConfig(va_display_, va_config_id_);
+      VA_LOG_ON_ERROR(va_res, "vaDestroyConfig failed");
+    }
 
-  if (va_display_) {
-    VAStatus va_res = vaTerminate(va_display_);
-    VA_LOG_ON_ERROR(va_res, "vaTerminate failed");
+    VADisplayState* display_state = va_display_state_.Pointer();
+    if (session_admitted_)
+      display_state->ReleaseSession(&release_cbs);
+    if (display_initialized_)
+      display_state->Deinitialize();
+
+    session_admitted_ = false;
+    display_initialized_ = false;
+    va_config_id_ = VA_INVALID_ID;
+    va_display_ = NULL;
   }
 
-  va_config_id_ = VA_INVALID_ID;
-  va_display_ = NULL;
+  // Sessions waiting for resources may call back into their wrappers.
+  for (size_t i = 0; i < release_cbs.size(); ++i)
+    release_cbs[i].Run();
+}
+
+bool VaapiWrapper::WaitForResources(const base::Closure& retry_cb) {
+  base::AutoLock auto_lock(*va_lock_);
+
+  if (!resources_exhausted_ || !session_admitted_)
+    return false;
+
+  return va_display_state_.Get().AddReleaseCallback(retry_cb);
 }
 
 bool VaapiWrapper::VAAPIVersionLessThan(int major, int minor) {
@@ -229,11 +442,19 @@ bool VaapiWrapper::VAAPIVersionLessThan(int major, int minor) {
       (major_version_ == major && minor_version_ < minor);
 }
 
+void VaapiWrapper::GetDriverTimings(base::TimeDelta* submit_decode_time,
+                                    base::TimeDelta* surface_sync_time) {
+  base::AutoLock auto_lock(*va_lock_);
+  *submit_decode_time = submit_decode_time_;
+  *surface_sync_time = surface_sync_time_;
+}
+
 bool VaapiWrapper::CreateSurfaces(gfx::Size size,
                                   size_t num_surfaces,
                                   std::vector<VASurfaceID>* va_surfaces) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
   DVLOG(2) << "Creating " << num_surfaces << " surfaces";
+  resources_exhausted_ = false;
 
   DCHECK(va_surfaces->empty());
   DCHECK(va_surface_ids_.empty());
@@ -249,6 +470,10 @@ bool VaapiWrapper::CreateSurfaces(gfx::Size size,
 
   VA_LOG_ON_ERROR(va_res, "vaCreateSurfaces failed");
   if (va_res != VA_STATUS_SUCCESS) {
+    if (va_res == VA_STATUS_ERROR_ALLOCATION_FAILED) {
+      va_display_state_.Get().OnSessionResourcesExhausted();
+      resources_exhausted_ = true;
+    }
     va_surface_ids_.clear();
     return false;
   }
@@ -261,7 +486,18 @@ bool VaapiWrapper::CreateSurfaces(gfx::Size size,
 
   VA_LOG_ON_ERROR(va_res, "vaCreateContext failed");
   if (va_res != VA_STATUS_SUCCESS) {
-    DestroySurfaces();
+    if (va_res == VA_STATUS_ERROR_ALLOCATION_FAILED ||
+        va_res == VA_STATUS_ERROR_MAX_NUM_EXCEEDED) {
+      va_display_state_.Get().OnSessionResourcesExhausted();
+      resources_exhausted_ = true;
+    }
+    // va_lock_ is already held, so release the surfaces directly rather
+    // than through DestroySurfaces().
+    va_res = vaDestroySurfaces(va_display_, &va_surface_ids_[0],
+                               va_surface_ids_.size());
+    VA_LOG_ON_ERROR(va_res, "vaDestroySurfaces failed");
+    va_surface_ids_.clear();
+    va_context_id_ = VA_INVALID_ID;
     return false;
   }
 
@@ -270,9 +506,11 @@ bool VaapiWrapper::CreateSurfaces(gfx::Size size,
 }
 
 void VaapiWrapper::DestroySurfaces() {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
   DVLOG(2) << "Destroying " << va_surface_ids_.size()  << " surfaces";
 
+  DestroySliceDataBuffers_Locked();
+
   if (va_context_id_ != VA_INVALID_ID) {
     VAStatus va_res = vaDestroyContext(va_display_, va_context_id_);
     VA_LOG_ON_ERROR(va_res, "vaDestroyContext failed");
@@ -291,7 +529,7 @@ void VaapiWrapper::DestroySurfaces() {
 bool VaapiWrapper::SubmitBuffer(VABufferType va_buffer_type,
                                 size_t size,
                                 void* buffer) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
 
   VABufferID buffer_id;
   VAStatus va_res = vaCreateBuffer(va_display_, va_context_id_,
@@ -313,8 +551,92 @@ bool VaapiWrapper::SubmitBuffer(VABufferType va_buffer_type,
   return true;
 }
 
+bool VaapiWrapper::SubmitSliceData(size_t size, const void* data) {
+  base::AutoLock auto_lock(*va_lock_);
+
+  SliceDataBuffer buffer;
+  if (!GetSliceDataBuffer_Locked(size, &buffer.id, &buffer.capacity))
+    return false;
+
+  void* mapped = NULL;
+  VAStatus va_res = vaMapBuffer(va_display_, buffer.id, &mapped);
+  if (va_res != VA_STATUS_SUCCESS) {
+    LOG_VA_ERROR_AND_REPORT(va_res, "vaMapBuffer failed for slice data");
+    free_slice_data_bufs_.push_back(buffer);
+    return false;
+  }
+
+  memcpy(mapped, data, size);
+
+  // The buffer may not stay mapped while the driver consumes it.
+  va_res = vaUnmapBuffer(va_display_, buffer.id);
+  VA_LOG_ON_ERROR(va_res, "vaUnmapBuffer failed for slice data");
+
+  pending_slice_bufs_.push_back(buffer.id);
+  pending_slice_data_bufs_.push_back(buffer);
+  return true;
+}
+
+bool VaapiWrapper::GetSliceDataBuffer_Locked(size_t size,
+                                             VABufferID* buffer_id,
+                                             size_t* capacity) {
+  va_lock_->AssertAcquired();
+
+  // Pick the smallest free buffer that fits.
+  std::vector<SliceDataBuffer>::iterator best = free_slice_data_bufs_.end();
+  for (std::vector<SliceDataBuffer>::iterator it =
+           free_slice_data_bufs_.begin();
+       it != free_slice_data_bufs_.end(); ++it) {
+    if (it->capacity >= size &&
+        (best == free_slice_data_bufs_.end() ||
+         it->capacity < best->capacity)) {
+      best = it;
+    }
+  }
+
+  if (best != free_slice_data_bufs_.end()) {
+    *buffer_id = best->id;
+    *capacity = best->capacity;
+    free_slice_data_bufs_.erase(best);
+    return true;
+  }
+
+  size_t new_capacity = kMinSliceDataBufferSize;
+  while (new_capacity < size)
+    new_capacity *= 2;
+
+  VAStatus va_res = vaCreateBuffer(va_display_, va_context_id_,
+                                   VASliceDataBufferType, new_capacity,
+                                   1, NULL, buffer_id);
+  VA_SUCCESS_OR_RETURN(va_res, "Failed to create a slice data buffer", false);
+
+  DVLOG(3) << "Allocated slice data buffer of " << new_capacity << " bytes";
+  *capacity = new_capacity;
+  return true;
+}
+
+void VaapiWrapper::DestroySliceDataBuffers_Locked() {
+  va_lock_->AssertAcquired();
+
+  for (size_t i = 0; i < pending_slice_data_bufs_.size(); ++i) {
+    VABufferID id = pending_slice_data_bufs_[i].id;
+    pending_slice_bufs_.erase(std::remove(pending_slice_bufs_.begin(),
+                                          pending_slice_bufs_.end(), id),
+                              pending_slice_bufs_.end());
+    free_slice_data_bufs_.push_back(pending_slice_data_bufs_[i]);
+  }
+  pending_slice_data_bufs_.clear();
+
+  for (size_t i = 0; i < free_slice_data_bufs_.size(); ++i) {
+    VAStatus va_res = vaDestroyBuffer(va_display_,
+                                      free_slice_data_bufs_[i].id);
+    VA_LOG_ON_ERROR(va_res, "vaDestroyBuffer failed");
+  }
+  free_slice_data_bufs_.clear();
+}
+
 void VaapiWrapper::DestroyPendingBuffers() {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
 
   for (size_t i = 0; i < pending_va_bufs_.size(); ++i) {
     VAStatus va_res = vaDestroyBuffer(va_display_, pending_va_bufs_[i]);
@@ -322,16 +644,41 @@ void VaapiWrapper::DestroyPendingBuffers() {
   }
 
   for (size_t i = 0; i < pending_slice_bufs_.size(); ++i) {
+    // Pooled slice data buffers are recycled below.
+    bool pooled = false;
+    for (size_t j = 0; j < pending_slice_data_bufs_.size(); ++j) {
+      if (pending_slice_data_bufs_[j].id == pending_slice_bufs_[i]) {
+        pooled = true;
+        break;
+      }
+    }
+    if (pooled)
+      continue;
+
     VAStatus va_res = vaDestroyBuffer(va_display_, pending_slice_bufs_[i]);
     VA_LOG_ON_ERROR(va_res, "vaDestroyBuffer failed");
   }
 
+  for (size_t i = 0; i < pending_slice_data_bufs_.size(); ++i) {
+    if (free_slice_data_bufs_.size() < kMaxFreeSliceDataBuffers) {
+      free_slice_data_bufs_.push_back(pending_slice_data_bufs_[i]);
+      continue;
+    }
+    VAStatus va_res = vaDestroyBuffer(va_display_,
+                                      pending_slice_data_bufs_[i].id);
+    VA_LOG_ON_ERROR(va_res, "vaDestroyBuffer failed");
+  }
+
   pending_va_bufs_.clear();
   pending_slice_bufs_.clear();
+  pending_slice_data_bufs_.clear();
 }
 
 bool VaapiWrapper::SubmitDecode(VASurfaceID va_surface_id) {
-  base::AutoLock auto_lock(va_lock_);
+  TRACE_EVENT1("Video Decoder", "VaapiWrapper::SubmitDecode",
+               "surface", va_surface_id);
+  base::AutoLock auto_lock(*va_lock_);
+  base::TimeTicks start = base::TimeTicks::Now();
 
   DVLOG(4) << "Pending VA bufs to commit: " << pending_va_bufs_.size();
   DVLOG(4) << "Pending slice bufs to commit: " << pending_slice_bufs_.size();
@@ -357,6 +704,7 @@ bool VaapiWrapper::SubmitDecode(VASurfaceID va_surface_id) {
   va_res = vaEndPicture(va_display_, va_context_id_);
   VA_SUCCESS_OR_RETURN(va_res, "vaEndPicture failed", false);
 
+  submit_decode_time_ += base::TimeTicks::Now() - start;
   return true;
 }
 
@@ -367,7 +715,7 @@ bool VaapiWrapper::DecodeAndDestroyPendingBuffers(VASurfaceID va_surface_id) {
 }
 
 bool VaapiWrapper::CreateRGBImage(gfx::Size size, VAImage* image) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
   VAStatus va_res;
   VAImageFormat format;
   format.fourcc = VA_FOURCC_RGBX;
@@ -388,12 +736,12 @@ bool VaapiWrapper::CreateRGBImage(gfx::Size size, VAImage* image) {
 }
 
 void VaapiWrapper::DestroyImage(VAImage* image) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
   vaDestroyImage(va_display_, image->image_id);
 }
 
 bool VaapiWrapper::MapImage(VAImage* image, void** buffer) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
 
   VAStatus va_res = vaMapBuffer(va_display_, image->buf, buffer);
   VA_SUCCESS_OR_RETURN(va_res, "Failed to map image", false);
@@ -401,14 +749,33 @@ bool VaapiWrapper::MapImage(VAImage* image, void** buffer) {
 }
 
 void VaapiWrapper::UnmapImage(VAImage* image) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
   vaUnmapBuffer(va_display_, image->buf);
 }
 
+VAStatus VaapiWrapper::SyncSurface_Locked(VASurfaceID va_surface_id) {
+  va_lock_->AssertAcquired();
+  TRACE_EVENT1("Video Decoder", "VaapiWrapper::SyncSurface",
+               "surface", va_surface_id);
+  base::TimeTicks start = base::TimeTicks::Now();
+  VAStatus va_res;
+  {
+    // Waiting for the hardware can take a frame time or more. Let the other
+    // sessions on the shared display go on meanwhile; the surface belongs to
+    // this wrapper and no other call touches it until the sync returns.
+    base::AutoUnlock auto_unlock(*va_lock_);
+    va_res = vaSyncSurface(va_display_, va_surface_id);
+  }
+  surface_sync_time_ += base::TimeTicks::Now() - start;
+  return va_res;
+}
+
 bool VaapiWrapper::PutSurfaceIntoImage(VASurfaceID va_surface_id,
-                                       VAImage* image) {
-  base::AutoLock auto_lock(va_lock_);
-  VAStatus va_res = vaSyncSurface(va_display_, va_surface_id);
+                                       VAImage* image,
+                                       bool* unsupported) {
+  base::AutoLock auto_lock(*va_lock_);
+  *unsupported = false;
+  VAStatus va_res = SyncSurface_Locked(va_surface_id);
   VA_SUCCESS_OR_RETURN(va_res, "Failed syncing surface", false);
 
   va_res = vaGetImage(va_display_,
@@ -418,15 +785,45 @@ bool VaapiWrapper::PutSurfaceIntoImage(VASurfaceID va_surface_id,
                       image->width,
                       image->height,
                       image->image_id);
+  *unsupported = va_res == VA_STATUS_ERROR_UNIMPLEMENTED ||
+                 va_res == VA_STATUS_ERROR_INVALID_IMAGE_FORMAT ||
+                 va_res == VA_STATUS_ERROR_UNSUPPORTED_RT_FORMAT;
   VA_SUCCESS_OR_RETURN(va_res, "Failed to put surface into image", false);
   return true;
 }
+
+bool VaapiWrapper::DeriveAndMapImage(VASurfaceID va_surface_id,
+                                     VAImage* image,
+                                     void** mem) {
+  base::AutoLock auto_lock(*va_lock_);
+  VAStatus va_res = SyncSurface_Locked(va_surface_id);
+  VA_SUCCESS_OR_RETURN(va_res, "Failed syncing surface", false);
+
+  va_res = vaDeriveImage(va_display_, va_surface_id, image);
+  VA_SUCCESS_OR_RETURN(va_res, "vaDeriveImage failed", false);
+
+  va_res = vaMapBuffer(va_display_, image->buf, mem);
+  VA_LOG_ON_ERROR(va_res, "vaMapBuffer failed");
+  if (va_res == VA_STATUS_SUCCESS)
+    return true;
+
+  vaDestroyImage(va_display_, image->image_id);
+  return false;
+}
+
+void VaapiWrapper::ReleaseDerivedImage(VAImage* image) {
+  base::AutoLock auto_lock(*va_lock_);
+
+  vaUnmapBuffer(va_display_, image->buf);
+  vaDestroyImage(va_display_, image->image_id);
+}
+
 bool VaapiWrapper::GetVaImageForTesting(VASurfaceID va_surface_id,
                                         VAImage* image,
                                         void** mem) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
 
-  VAStatus va_res = vaSyncSurface(va_display_, va_surface_id);
+  VAStatus va_res = SyncSurface_Locked(va_surface_id);
   VA_SUCCESS_OR_RETURN(va_res, "Failed syncing surface", false);
 
   // Derive a VAImage from the VASurface
@@ -446,7 +843,7 @@ bool VaapiWrapper::GetVaImageForTesting(VASurfaceID va_surface_id,
 }
 
 void VaapiWrapper::ReturnVaImageForTesting(VAImage* image) {
-  base::AutoLock auto_lock(va_lock_);
+  base::AutoLock auto_lock(*va_lock_);
 
   vaUnmapBuffer(va_display_, image->buf);
   vaDestroyImage(va_display_, image->image_id);
@@ -11,8 +11,10 @@
 
 #include <vector>
 #include "base/callback.h"
+#include "base/lazy_instance.h"
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "media/base/video_decoder_config.h"
 #include "media/base/video_frame.h"
@@ -28,6 +30,11 @@ namespace media {
 // synchronous and its methods can be called from any thread and may wait on
 // the va_lock_ while other, concurrent calls run.
 //
+// All VaapiWrappers in the process share a single VA display connection, and
+// with it the lock serializing calls into libva. Each wrapper is a separate
+// decode session with its own config and context. The number of concurrent
+// sessions is limited, see Create().
+//
 // This class is responsible for managing VAAPI connection, contexts and state.
 // It is also responsible for managing and freeing VABuffers (not VASurfaces),
 // which are used to queue decode parameters and slice data to the HW decoder,
@@ -36,6 +43,9 @@ class CONTENT_EXPORT VaapiWrapper {
  public:
   // |report_error_to_uma_cb| will be called independently from reporting
   // errors to clients via method return values.
+  // Returns NULL if the hardware is already running the maximum number of
+  // decode sessions, in which case the client is expected to fall back to
+  // software decode. Sessions created earlier have priority over new ones.
   static scoped_ptr<VaapiWrapper> Create(
       media::VideoCodecProfile profile,
       void* display,
@@ -57,6 +67,12 @@ class CONTENT_EXPORT VaapiWrapper {
   // Free all memory allocated in CreateSurfaces.
   void DestroySurfaces();
 
+  // Call after CreateSurfaces() failed. If the driver ran out of resources
+  // while other decode sessions are running, |retry_cb| is run once one of
+  // them ends, on the thread ending it, and true is returned. Returns false
+  // if retrying cannot help.
+  bool WaitForResources(const base::Closure& retry_cb);
+
   // Submit parameters or slice data of |va_buffer_type|, copying them from
   // |buffer| of size |size|, into HW decoder. The data in |buffer| is no
   // longer needed and can be freed after this method returns.
@@ -65,6 +81,13 @@ class CONTENT_EXPORT VaapiWrapper {
   // DestroyPendingBuffers is used to cancel a pending decode.
   bool SubmitBuffer(VABufferType va_buffer_type, size_t size, void* buffer);
 
+  // Submit |size| bytes of slice data from |data| into HW decoder. Unlike
+  // SubmitBuffer(), the data is copied straight into a VA buffer recycled from
+  // a pool kept for the current context, so no driver buffer has to be
+  // allocated per slice. Pooled buffers are returned to the pool when pending
+  // buffers are destroyed and freed along with the context.
+  bool SubmitSliceData(size_t size, const void* data);
+
   // Cancel and destroy all buffers queued to the HW decoder via SubmitBuffer.
   // Useful when a pending decode is to be cancelled (on reset or error).
   void DestroyPendingBuffers();
@@ -80,11 +103,32 @@ class CONTENT_EXPORT VaapiWrapper {
   void UnmapImage(VAImage* image);
 
   // Put data from |va_surface_id| into |va_image|, converting/scaling it.
+  // On failure, |unsupported| tells whether the driver cannot convert into the
+  // format of |va_image| at all, as opposed to failing for this surface only.
   bool PutSurfaceIntoImage(VASurfaceID va_surface_id,
-                           VAImage* va_image);
+                           VAImage* va_image,
+                           bool* unsupported);
+
+  // Wait for |va_surface_id| to be decoded, derive a VAImage giving direct
+  // access to its contents in the native format of the surface and map it
+  // into memory at |mem|. The image must be released with
+  // ReleaseDerivedImage(). Returns true when successful.
+  bool DeriveAndMapImage(VASurfaceID va_surface_id,
+                         VAImage* image,
+                         void** mem);
+
+  // Unmap and destroy an image obtained from DeriveAndMapImage().
+  void ReleaseDerivedImage(VAImage* image);
+
   // Returns true if the VAAPI version is less than the specified version.
   bool VAAPIVersionLessThan(int major, int minor);
 
+  // Return the time accumulated since creation in SubmitDecode() and in
+  // waiting for surfaces to become ready in vaSyncSurface(). Used for
+  // instrumentation only.
+  void GetDriverTimings(base::TimeDelta* submit_decode_time,
+                        base::TimeDelta* surface_sync_time);
+
   // Get a VAImage from a VASurface and map it into memory. The VAImage should
   // be released using the ReturnVaImage function. Returns true when successful.
   // This is intended for testing only.
@@ -109,6 +153,19 @@ class CONTENT_EXPORT VaapiWrapper {
   // by client or if decode fails in hardware.
   bool SubmitDecode(VASurfaceID va_surface_id);
 
+  // Wait for |va_surface_id| to be decoded. |va_lock_| must be held, but is
+  // released during the wait.
+  VAStatus SyncSurface_Locked(VASurfaceID va_surface_id);
+
+  // Find a pooled slice data buffer of at least |size| bytes, creating a new
+  // one if none is available. Returns false if the driver fails to allocate.
+  bool GetSliceDataBuffer_Locked(size_t size, VABufferID* buffer_id,
+                                 size_t* capacity);
+
+  // Destroy all pooled slice data buffers, including pending ones. Must be
+  // called before the context they belong to is destroyed.
+  void DestroySliceDataBuffers_Locked();
+
   // Attempt to set render mode to "render to texture.". Failure is non-fatal.
   void TryToSetVADisplayAttributeToLocalGPU();
 
@@ -116,10 +173,25 @@ class CONTENT_EXPORT VaapiWrapper {
   // init failure.
   static bool PostSandboxInitialization();
 
+  // Process-wide state of the shared VA display, defined in the .cc file.
+  class VADisplayState;
+  static base::LazyInstance<VADisplayState>::Leaky va_display_state_;
+
   // Libva is not thread safe, so we have to do locking for it ourselves.
-  // This lock is to be taken for the duration of all VA-API calls and for
-  // the entire decode execution sequence in DecodeAndDestroyPendingBuffers().
-  base::Lock va_lock_;
+  // This lock is to be taken for the duration of all VA-API calls, except
+  // waiting in vaSyncSurface(), and for the entire decode execution sequence
+  // in DecodeAndDestroyPendingBuffers().
+  // It is owned by the shared VADisplayState, as all wrappers use the same
+  // VADisplay.
+  base::Lock* va_lock_;
+
+  // Whether this wrapper holds a reference to the shared display and an
+  // admitted decode session, respectively.
+  bool display_initialized_;
+  bool session_admitted_;
+
+  // Whether the last CreateSurfaces() failed for lack of resources.
+  bool resources_exhausted_;
 
   // Allocated ids for VASurfaces.
   std::vector<VASurfaceID> va_surface_ids_;
@@ -139,6 +211,20 @@ class CONTENT_EXPORT VaapiWrapper {
   std::vector<VABufferID> pending_slice_bufs_;
   std::vector<VABufferID> pending_va_bufs_;
 
+  // Pool of slice data buffers for SubmitSliceData(). Buffers queued for the
+  // next decode also appear in pending_slice_bufs_, to keep the order of
+  // slice parameters and data, but are recycled instead of destroyed.
+  struct SliceDataBuffer {
+    VABufferID id;
+    size_t capacity;
+  };
+  std::vector<SliceDataBuffer> free_slice_data_bufs_;
+  std::vector<SliceDataBuffer> pending_slice_data_bufs_;
+
+  // Accumulated driver time, see GetDriverTimings(). Protected by va_lock_.
+  base::TimeDelta submit_decode_time_;
+  base::TimeDelta surface_sync_time_;
+
   // Called to report decoding errors to UMA. Errors to clients are reported via
   // return values from public methods.
   base::Closure report_error_to_uma_cb_;
@@ -4,30 +4,99 @@
 
 #include "ozone/ui/cursor/cursor_factory_ozone_wayland.h"
 
+#include <string>
+
+#include "base/hash.h"
+#include "ozone/ui/events/window_state_change_handler.h"
+#include "ui/base/cursor/cursor.h"
+
 namespace ui {
 
+namespace {
+
+CursorWayland* ToCursorWayland(PlatformCursor cursor) {
+  return static_cast<CursorWayland*>(cursor);
+}
+
+uint32 HashImage(const SkBitmap& bitmap, const gfx::Point& hotspot) {
+  SkAutoLockPixels lock(bitmap);
+  uint32 header[] = {
+    static_cast<uint32>(bitmap.width()),
+    static_cast<uint32>(bitmap.height()),
+    static_cast<uint32>(bitmap.colorType()),
+    static_cast<uint32>(hotspot.x()),
+    static_cast<uint32>(hotspot.y())
+  };
+
+  std::string data(reinterpret_cast<const char*>(header), sizeof(header));
+  if (bitmap.getPixels()) {
+    data.append(static_cast<const char*>(bitmap.getPixels()),
+                bitmap.getSize());
+  }
+  return base::Hash(data);
+}
+
+}  // namespace
+
+CursorWayland::CursorWayland(int type)
+    : type_(type),
+      hash_(0) {
+}
+
+CursorWayland::CursorWayland(const SkBitmap& bitmap, const gfx::Point& hotspot)
+    : type_(kCursorCustom),
+      bitmap_(bitmap),
+      hotspot_(hotspot),
+      hash_(HashImage(bitmap, hotspot)) {
+}
+
+CursorWayland::~CursorWayland() {
+}
+
 CursorFactoryOzoneWayland::CursorFactoryOzoneWayland() {}
 
 CursorFactoryOzoneWayland::~CursorFactoryOzoneWayland() {}
 
 PlatformCursor CursorFactoryOzoneWayland::GetDefaultCursor(int type) {
-  return NULL;
+  scoped_refptr<CursorWayland>& cursor = default_cursors_[type];
+  if (!cursor)
+    cursor = new CursorWayland(type);
+  return cursor.get();
 }
 
 PlatformCursor CursorFactoryOzoneWayland::CreateImageCursor(
     const SkBitmap& bitmap,
     const gfx::Point& hotspot) {
-  return NULL;
+  CursorWayland* cursor = new CursorWayland(bitmap, hotspot);
+  // The caller owns a reference, released with UnrefImageCursor().
+  cursor->AddRef();
+  return cursor;
 }
 
 void CursorFactoryOzoneWayland::RefImageCursor(PlatformCursor cursor) {
+  ToCursorWayland(cursor)->AddRef();
 }
 
 void CursorFactoryOzoneWayland::UnrefImageCursor(PlatformCursor cursor) {
+  ToCursorWayland(cursor)->Release();
 }
 
 void CursorFactoryOzoneWayland::SetCursor(gfx::AcceleratedWidget widget,
-                                   PlatformCursor cursor) {
+                                          PlatformCursor platform_cursor) {
+  if (!platform_cursor)
+    return;
+
+  // The compositor shows one cursor per seat, whichever window has focus.
+  CursorWayland* cursor = ToCursorWayland(platform_cursor);
+  WindowStateChangeHandler* handler = WindowStateChangeHandler::GetInstance();
+  if (cursor->type() != kCursorCustom) {
+    handler->SetWidgetCursor(cursor->type());
+    return;
+  }
+
+  handler->SetWidgetImageCursor(cursor->hash(),
+                                cursor->bitmap(),
+                                cursor->hotspot());
 }
 
 }  // namespace ui
@@ -5,10 +5,43 @@
 #ifndef OZONE_UI_CURSOR_CURSOR_FACTORY_OZONE_WAYLAND_H_
 #define OZONE_UI_CURSOR_CURSOR_FACTORY_OZONE_WAYLAND_H_
 
+#include <map>
+
+#include "base/memory/ref_counted.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/point.h"
 #include "ui/ozone/public/cursor_factory_ozone.h"
 
 namespace ui {
 
+// A cursor of the theme, identified by its type, or an image cursor. Image
+// cursors carry a hash of their contents, which lets the process talking to
+// the compositor upload each image only once.
+class CursorWayland : public base::RefCounted<CursorWayland> {
+ public:
+  explicit CursorWayland(int type);
+  CursorWayland(const SkBitmap& bitmap, const gfx::Point& hotspot);
+
+  int type() const { return type_; }
+  const SkBitmap& bitmap() const { return bitmap_; }
+  const gfx::Point& hotspot() const { return hotspot_; }
+  uint32 hash() const { return hash_; }
+
+ private:
+  friend class base::RefCounted<CursorWayland>;
+  ~CursorWayland();
+
+  int type_;
+  SkBitmap bitmap_;
+  gfx::Point hotspot_;
+  uint32 hash_;
+
+  DISALLOW_COPY_AND_ASSIGN(CursorWayland);
+};
+
+// PlatformCursors handed out by this factory are CursorWayland pointers.
+// Cursors are set through WindowStateChangeHandler, which talks to the
+// compositor directly when in process and through the GPU channel otherwise.
 class CursorFactoryOzoneWayland : public CursorFactoryOzone {
  public:
   CursorFactoryOzoneWayland();
@@ -21,6 +54,12 @@ class CursorFactoryOzoneWayland : public CursorFactoryOzone {
   virtual void UnrefImageCursor(PlatformCursor cursor) OVERRIDE;
   virtual void SetCursor(gfx::AcceleratedWidget widget,
                          PlatformCursor cursor) OVERRIDE;
+
+ private:
+  // Theme cursors live as long as the factory.
+  std::map<int, scoped_refptr<CursorWayland> > default_cursors_;
+
+  DISALLOW_COPY_AND_ASSIGN(CursorFactoryOzoneWayland);
 };
 
 }  // namespace ui
@@ -23,6 +23,7 @@
 #include "ui/events/event_utils.h"
 #include "ui/gfx/insets.h"
 #include "ui/native_theme/native_theme.h"
+#include "ui/ozone/public/cursor_factory_ozone.h"
 #include "ui/ozone/public/ozone_platform.h"
 #include "ui/ozone/public/surface_factory_ozone.h"
 #include "ui/platform_window/platform_window.h"
@@ -60,6 +61,10 @@ DesktopWindowTreeHostWayland::DesktopWindowTreeHostWayland(
       previous_maximize_bounds_(0, 0, 0, 0),
       window_(0),
       title_(base::string16()),
+      transparent_(false),
+      opacity_(255),
+      pointer_locked_(false),
+      blanked_(false),
       close_widget_factory_(this),
       drag_drop_client_(NULL),
       native_widget_delegate_(native_widget_delegate),
@@ -179,9 +184,27 @@ void DesktopWindowTreeHostWayland::InitWaylandWindow(
       break;
   }
 
+  transparent_ =
+      params.opacity == Widget::InitParams::TRANSLUCENT_WINDOW;
+  UpdateWidgetOpaque();
+
   CreateCompositor(GetAcceleratedWidget());
 }
 
+void DesktopWindowTreeHostWayland::UpdateWidgetOpaque() {
+  ui::WindowStateChangeHandler::GetInstance()->SetWidgetOpaque(
+      window_, !ShouldWindowContentsBeTransparent() && opacity_ == 255);
+}
+
+void DesktopWindowTreeHostWayland::SetPointerLocked(bool locked) {
+  if (pointer_locked_ == locked)
+    return;
+
+  pointer_locked_ = locked;
+  ui::WindowStateChangeHandler::GetInstance()->SetWidgetPointerConstraint(
+      window_, locked ? ui::POINTER_LOCKED : ui::POINTER_UNCONSTRAINED);
+}
+
 void DesktopWindowTreeHostWayland::OnAcceleratedWidgetAvailable(
       gfx::AcceleratedWidget widget) {
   window_ = widget;
@@ -489,6 +512,7 @@ bool DesktopWindowTreeHostWayland::IsMinimized() const {
 }
 
 void DesktopWindowTreeHostWayland::OnCaptureReleased() {
+  SetPointerLocked(false);
   OnHostLostWindowCapture();
   native_widget_delegate_->OnMouseCaptureLost();
 }
@@ -555,7 +579,7 @@ bool DesktopWindowTreeHostWayland::ShouldUseNativeFrame() const {
 }
 
 bool DesktopWindowTreeHostWayland::ShouldWindowContentsBeTransparent() const {
-  return false;
+  return transparent_;
 }
 
 void DesktopWindowTreeHostWayland::FrameTypeChanged() {
@@ -621,8 +645,13 @@ bool DesktopWindowTreeHostWayland::IsFullscreen() const {
 }
 
 void DesktopWindowTreeHostWayland::SetOpacity(unsigned char opacity) {
-  // TODO(erg):
-  NOTIMPLEMENTED();
+  // Wayland has no window opacity, the compositor uses the alpha of the
+  // contents. Just stop advertising the window as opaque while it is not.
+  if (opacity_ == opacity)
+    return;
+
+  opacity_ = opacity;
+  UpdateWidgetOpaque();
 }
 
 void DesktopWindowTreeHostWayland::SetWindowIcons(
@@ -734,8 +763,21 @@ void DesktopWindowTreeHostWayland::ReleaseCapture() {
   g_delegate_ozone_wayland_->SetCapture(NULL);
 }
 
+void DesktopWindowTreeHostWayland::OnMouseLockChanged(bool locked) {
+  // Have the compositor lock the pointer for Pointer Lock, so that it keeps
+  // reporting motion past the edges of the window.
+  SetPointerLocked(locked);
+}
+
 void DesktopWindowTreeHostWayland::SetCursorNative(gfx::NativeCursor cursor) {
-  // TODO(kalyan): Add support for custom cursor.
+  // Cursors loaded through the cursor factory, including image cursors, carry
+  // their platform cursor.
+  if (cursor.platform()) {
+    ui::CursorFactoryOzone::GetInstance()->SetCursor(window_,
+                                                     cursor.platform());
+    return;
+  }
+
   ui::WindowStateChangeHandler::GetInstance()->SetWidgetCursor(
       cursor.native_type());
 }
@@ -791,6 +833,18 @@ void DesktopWindowTreeHostWayland::HandleWindowResize(unsigned width,
   }
 }
 
+void DesktopWindowTreeHostWayland::HandleWindowBlanked(bool blanked) {
+  if (blanked_ == blanked)
+    return;
+
+  blanked_ = blanked;
+  // An invisible compositor produces no frames, and doesn't acknowledge those
+  // of the renderers, which then stop drawing and uploading video frames too.
+  compositor()->SetVisible(!blanked_);
+  if (!blanked_)
+    compositor()->ScheduleFullRedraw();
+}
+
 void DesktopWindowTreeHostWayland::HandleCommit(const std::string& text) {
   ui::InputMethodAuraLinux* inputMethod =
       static_cast<ui::InputMethodAuraLinux*>(desktop_native_widget_aura_->
@@ -74,6 +74,11 @@ class VIEWS_EXPORT DesktopWindowTreeHostWayland
   // initialization related to talking to the Ozone server.
   void InitWaylandWindow(const views::Widget::InitParams& params);
 
+  // Lets the compositor know whether the window contents are fully opaque.
+  void UpdateWidgetOpaque();
+  // Locks the pointer in place over the window, or releases it.
+  void SetPointerLocked(bool locked);
+
   // Called when another DRWHL takes capture, or when capture is released
   // entirely.
   void OnCaptureReleased();
@@ -164,6 +169,7 @@ class VIEWS_EXPORT DesktopWindowTreeHostWayland
   virtual gfx::Point GetLocationOnNativeScreen() const OVERRIDE;
   virtual void SetCapture() OVERRIDE;
   virtual void ReleaseCapture() OVERRIDE;
+  virtual void OnMouseLockChanged(bool locked) OVERRIDE;
   virtual void SetCursorNative(gfx::NativeCursor cursor) OVERRIDE;
   virtual void OnCursorVisibilityChangedNative(bool show) OVERRIDE;
   virtual void MoveCursorToNative(const gfx::Point& location) OVERRIDE;
@@ -171,6 +177,9 @@ class VIEWS_EXPORT DesktopWindowTreeHostWayland
 
   void HandleNativeWidgetActivationChanged(bool active);
   void HandleWindowResize(unsigned width, unsigned height);
+  // Stops the compositor while nothing of the window can be seen. Renderers
+  // keep their state, so that drawing resumes with the next frame.
+  void HandleWindowBlanked(bool blanked);
 
   void HandlePreeditChanged(const std::string& text, const std::string& commit);
   void HandleCommit(const std::string& text);
@@ -185,6 +194,13 @@ class VIEWS_EXPORT DesktopWindowTreeHostWayland
   gfx::AcceleratedWidget window_;
   base::string16 title_;
 
+  // Whether the window was created translucent, and the opacity last set by
+  // SetOpacity().
+  bool transparent_;
+  unsigned char opacity_;
+  bool pointer_locked_;
+  bool blanked_;
+
   base::WeakPtrFactory<DesktopWindowTreeHostWayland> close_widget_factory_;
 
   // Owned by DesktopNativeWidgetAura.
@@ -289,6 +289,15 @@ void WindowTreeHostDelegateWayland::OnWindowResized(unsigned handle,
   window->HandleWindowResize(width, height);
 }
 
+void WindowTreeHostDelegateWayland::OnWindowBlanked(unsigned handle,
+                                                    bool blanked) {
+  DesktopWindowTreeHostWayland* window =
+      DesktopWindowTreeHostWayland::GetHostForAcceleratedWidget(handle);
+  // The window may be gone by the time the notification arrives.
+  if (window)
+    window->HandleWindowBlanked(blanked);
+}
+
 void WindowTreeHostDelegateWayland::OnCommit(unsigned handle,
                                              const std::string& text) {
   DesktopWindowTreeHostWayland* window =
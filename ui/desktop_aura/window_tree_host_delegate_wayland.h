@@ -57,6 +57,7 @@ class WindowTreeHostDelegateWayland
   virtual void OnWindowResized(unsigned windowhandle,
                                unsigned width,
                                unsigned height) OVERRIDE;
+  virtual void OnWindowBlanked(unsigned windowhandle, bool blanked) OVERRIDE;
   virtual void OnPreeditChanged(unsigned handle,
                                 const std::string& text,
                                 const std::string& commit) OVERRIDE;
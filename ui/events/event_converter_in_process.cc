@@ -5,11 +5,65 @@
 #include "ozone/ui/events/event_converter_in_process.h"
 
 #include "base/bind.h"
+#include "base/metrics/histogram.h"
+#include "ui/gfx/point_conversions.h"
 #include "ozone/ui/events/output_change_observer.h"
 #include "ozone/ui/events/window_change_observer.h"
 
 namespace ui {
 
+namespace {
+
+enum InputLatencyType {
+  INPUT_LATENCY_KEY,
+  INPUT_LATENCY_MOUSE_MOVE,
+  INPUT_LATENCY_MOUSE_BUTTON,
+  INPUT_LATENCY_MOUSE_WHEEL,
+  INPUT_LATENCY_TOUCH
+};
+
+// Larger differences mean the compositor's clock is not the monotonic one.
+const int64 kMaxInputLatencyMs = 60 * 1000;
+
+// Returns the ui::Event time stamp of an event the compositor sent at
+// |time_stamp|, and records how long the event took to get to dispatch.
+// Compositors use the monotonic clock in milliseconds for event times, like
+// base::TimeTicks on Linux, but truncated to 32 bits.
+base::TimeDelta EventTimeFromCompositorTime(uint32_t time_stamp,
+                                            InputLatencyType type) {
+  base::TimeDelta now = base::TimeTicks::Now() - base::TimeTicks();
+  if (!time_stamp)
+    return now;
+
+  uint32_t elapsed_ms =
+      static_cast<uint32_t>(now.InMilliseconds()) - time_stamp;
+  if (elapsed_ms > kMaxInputLatencyMs)
+    return now;
+
+  base::TimeDelta latency = base::TimeDelta::FromMilliseconds(elapsed_ms);
+  switch (type) {
+    case INPUT_LATENCY_KEY:
+      UMA_HISTOGRAM_TIMES("Ozone.Wayland.InputLatency.Key", latency);
+      break;
+    case INPUT_LATENCY_MOUSE_MOVE:
+      UMA_HISTOGRAM_TIMES("Ozone.Wayland.InputLatency.MouseMove", latency);
+      break;
+    case INPUT_LATENCY_MOUSE_BUTTON:
+      UMA_HISTOGRAM_TIMES("Ozone.Wayland.InputLatency.MouseButton", latency);
+      break;
+    case INPUT_LATENCY_MOUSE_WHEEL:
+      UMA_HISTOGRAM_TIMES("Ozone.Wayland.InputLatency.MouseWheel", latency);
+      break;
+    case INPUT_LATENCY_TOUCH:
+      UMA_HISTOGRAM_TIMES("Ozone.Wayland.InputLatency.Touch", latency);
+      break;
+  }
+
+  return now - latency;
+}
+
+}  // namespace
+
 EventConverterInProcess::EventConverterInProcess()
     : EventConverterOzoneWayland(),
       observer_(NULL),
@@ -19,27 +73,51 @@ EventConverterInProcess::EventConverterInProcess()
 EventConverterInProcess::~EventConverterInProcess() {
 }
 
-void EventConverterInProcess::MotionNotify(float x, float y) {
+void EventConverterInProcess::MotionNotify(float x,
+                                           float y,
+                                           uint32_t time_stamp) {
   ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
-      &EventConverterInProcess::NotifyMotion, this, x, y));
+      &EventConverterInProcess::NotifyMotion, this, x, y, time_stamp));
 }
 
 void EventConverterInProcess::ButtonNotify(unsigned handle,
                                            ui::EventType type,
                                            ui::EventFlags flags,
                                            float x,
-                                           float y) {
+                                           float y,
+                                           uint32_t time_stamp) {
   ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
       &EventConverterInProcess::NotifyButtonPress, this, handle, type,
-          flags, x, y));
+          flags, x, y, time_stamp));
 }
 
 void EventConverterInProcess::AxisNotify(float x,
                                          float y,
                                          int xoffset,
-                                         int yoffset) {
+                                         int yoffset,
+                                         uint32_t time_stamp) {
   ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
-      &EventConverterInProcess::NotifyAxis, this, x, y, xoffset, yoffset));
+      &EventConverterInProcess::NotifyAxis, this, x, y, xoffset, yoffset,
+          time_stamp));
+}
+
+void EventConverterInProcess::ScrollNotify(ui::EventType type,
+                                           float x,
+                                           float y,
+                                           float x_offset,
+                                           float y_offset,
+                                           uint32_t time_stamp) {
+  ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
+      &EventConverterInProcess::NotifyScroll, this, type, x, y, x_offset,
+          y_offset, time_stamp));
+}
+
+void EventConverterInProcess::RelativeMotionNotify(float dx,
+                                                   float dy,
+                                                   uint32_t time_stamp) {
+  ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
+      &EventConverterInProcess::NotifyRelativeMotion, this, dx, dy,
+          time_stamp));
 }
 
 void EventConverterInProcess::PointerEnter(unsigned handle,
@@ -56,23 +134,15 @@ void EventConverterInProcess::PointerLeave(unsigned handle,
       &EventConverterInProcess::NotifyPointerLeave, this, handle, x, y));
 }
 
-void EventConverterInProcess::KeyNotify(ui::EventType type,
-                                        unsigned code,
-                                        unsigned modifiers) {
+void EventConverterInProcess::KeyNotify(const ui::ResolvedKeyEvent& event) {
   ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
-      &EventConverterInProcess::NotifyKeyEvent, this, type,
-          ui::KeyboardCodeFromNativeKeysym(code),
-              ui::CharacterCodeFromNativeKeySym(code, modifiers), modifiers));
+      &EventConverterInProcess::NotifyKeyEvent, this, event));
 }
 
-void EventConverterInProcess::TouchNotify(ui::EventType type,
-                                          float x,
-                                          float y,
-                                          int32_t touch_id,
-                                          uint32_t time_stamp) {
+void EventConverterInProcess::TouchFrameNotify(
+    const std::vector<ui::TouchUpdate>& updates) {
   ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
-      &EventConverterInProcess::NotifyTouchEvent, this, type, x, y, touch_id,
-          time_stamp));
+      &EventConverterInProcess::NotifyTouchFrame, this, updates));
 }
 
 void EventConverterInProcess::CloseWidget(unsigned handle) {
@@ -94,6 +164,17 @@ void EventConverterInProcess::WindowResized(unsigned handle,
           height));
 }
 
+void EventConverterInProcess::WindowBlanked(unsigned handle, bool blanked) {
+  ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
+      &EventConverterInProcess::NotifyWindowBlanked, this, handle, blanked));
+}
+
+void EventConverterInProcess::ImageCursorMissing(uint32 hash) {
+  // Cursor images are only ever set without their bitmap across IPC, and
+  // OzoneChannelHost handles the reply.
+  NOTREACHED();
+}
+
 void EventConverterInProcess::Commit(unsigned handle, const std::string& text) {
   ui::EventConverterOzoneWayland::PostTaskOnMainLoop(base::Bind(
       &EventConverterInProcess::NotifyCommit, this, handle, text));
@@ -141,13 +222,17 @@ void EventConverterInProcess::OnDispatcherListChanged() {
 
 void EventConverterInProcess::NotifyMotion(EventConverterInProcess* data,
                                            float x,
-                                           float y) {
+                                           float y,
+                                           uint32_t time_stamp) {
+  data->pointer_location_.SetPoint(x, y);
   gfx::Point position(x, y);
   ui::MouseEvent mouseev(ui::ET_MOUSE_MOVED,
                          position,
                          position,
                          0,
                          0);
+  mouseev.set_time_stamp(
+      EventTimeFromCompositorTime(time_stamp, INPUT_LATENCY_MOUSE_MOVE));
   data->DispatchEvent(&mouseev);
 }
 
@@ -156,13 +241,16 @@ void EventConverterInProcess::NotifyButtonPress(EventConverterInProcess* data,
                                                 ui::EventType type,
                                                 ui::EventFlags flags,
                                                 float x,
-                                                float y) {
+                                                float y,
+                                                uint32_t time_stamp) {
     gfx::Point position(x, y);
     ui::MouseEvent mouseev(type,
                            position,
                            position,
                            flags,
                            1);
+    mouseev.set_time_stamp(
+        EventTimeFromCompositorTime(time_stamp, INPUT_LATENCY_MOUSE_BUTTON));
     data->DispatchEvent(&mouseev);
 
     if (type == ui::ET_MOUSE_RELEASED && data->observer_)
@@ -173,19 +261,62 @@ void EventConverterInProcess::NotifyAxis(EventConverterInProcess* data,
                                          float x,
                                          float y,
                                          int xoffset,
-                                         int yoffset) {
+                                         int yoffset,
+                                         uint32_t time_stamp) {
   gfx::Point position(x, y);
   ui::MouseEvent mouseev(ui::ET_MOUSEWHEEL, position, position, 0, 0);
+  mouseev.set_time_stamp(
+      EventTimeFromCompositorTime(time_stamp, INPUT_LATENCY_MOUSE_WHEEL));
   ui::MouseWheelEvent wheelev(mouseev, xoffset, yoffset);
 
   data->DispatchEvent(&wheelev);
 }
 
+void EventConverterInProcess::NotifyScroll(EventConverterInProcess* data,
+                                           ui::EventType type,
+                                           float x,
+                                           float y,
+                                           float x_offset,
+                                           float y_offset,
+                                           uint32_t time_stamp) {
+  // Wayland doesn't tell how many fingers scroll, two is what touchpads use.
+  ui::ScrollEvent scrollev(
+      type,
+      gfx::PointF(x, y),
+      EventTimeFromCompositorTime(time_stamp, INPUT_LATENCY_MOUSE_WHEEL),
+      0,
+      x_offset,
+      y_offset,
+      x_offset,
+      y_offset,
+      2);
+  data->DispatchEvent(&scrollev);
+}
+
+void EventConverterInProcess::NotifyRelativeMotion(
+    EventConverterInProcess* data, float dx, float dy, uint32_t time_stamp) {
+  // Aura has no relative mouse events, it tells how far a locked mouse moved
+  // from the locations of successive mouse moves. Those are then outside of
+  // the window once the mouse moved far enough, which is fine for the window
+  // holding the capture.
+  data->pointer_location_ += gfx::Vector2dF(dx, dy);
+  gfx::Point position = gfx::ToFlooredPoint(data->pointer_location_);
+  ui::MouseEvent mouseev(ui::ET_MOUSE_MOVED,
+                         position,
+                         position,
+                         0,
+                         0);
+  mouseev.set_time_stamp(
+      EventTimeFromCompositorTime(time_stamp, INPUT_LATENCY_MOUSE_MOVE));
+  data->DispatchEvent(&mouseev);
+}
+
 void EventConverterInProcess::NotifyPointerEnter(
     EventConverterInProcess* data, unsigned handle, float x, float y) {
   if (data->observer_)
     data->observer_->OnWindowEnter(handle);
 
+  data->pointer_location_.SetPoint(x, y);
   gfx::Point position(x, y);
   ui::MouseEvent mouseev(ui::ET_MOUSE_ENTERED, position, position, 0, 0);
   data->DispatchEvent(&mouseev);
@@ -201,26 +332,29 @@ void EventConverterInProcess::NotifyPointerLeave(
   data->DispatchEvent(&mouseev);
 }
 
-void EventConverterInProcess::NotifyKeyEvent(EventConverterInProcess* data,
-                                             ui::EventType type,
-                                             ui::KeyboardCode code,
-                                             uint16 CharacterCodeFromNativeKey,
-                                             unsigned modifiers) {
-  ui::KeyEvent keyev(type, code, modifiers);
-  keyev.set_character(CharacterCodeFromNativeKey);
+void EventConverterInProcess::NotifyKeyEvent(
+    EventConverterInProcess* data,
+    const ui::ResolvedKeyEvent& event) {
+  ui::KeyEvent keyev(event.type, event.key_code, event.code, event.flags);
+  keyev.set_character(event.character);
+  keyev.set_time_stamp(
+      EventTimeFromCompositorTime(event.time_stamp, INPUT_LATENCY_KEY));
   data->DispatchEvent(&keyev);
 }
 
-void EventConverterInProcess::NotifyTouchEvent(EventConverterInProcess* data,
-                                               ui::EventType type,
-                                               float x,
-                                               float y,
-                                               int32_t touch_id,
-                                               uint32_t time_stamp) {
-  gfx::Point position(x, y);
-  base::TimeDelta time_delta = base::TimeDelta::FromMilliseconds(time_stamp);
-  ui::TouchEvent touchev(type, position, touch_id, time_delta);
-  data->DispatchEvent(&touchev);
+void EventConverterInProcess::NotifyTouchFrame(
+    EventConverterInProcess* data,
+    const std::vector<ui::TouchUpdate>& updates) {
+  for (std::vector<ui::TouchUpdate>::const_iterator it = updates.begin();
+       it != updates.end(); ++it) {
+    ui::TouchEvent touchev(
+        it->type,
+        gfx::Point(it->x, it->y),
+        it->touch_id,
+        EventTimeFromCompositorTime(it->time_stamp, INPUT_LATENCY_TOUCH));
+    touchev.set_source_device_id(it->seat_id);
+    data->DispatchEvent(&touchev);
+  }
 }
 
 void EventConverterInProcess::NotifyCloseWidget(
@@ -246,6 +380,14 @@ EventConverterInProcess::NotifyWindowResized(EventConverterInProcess* data,
     data->observer_->OnWindowResized(handle, width, height);
 }
 
+void
+EventConverterInProcess::NotifyWindowBlanked(EventConverterInProcess* data,
+                                             unsigned handle,
+                                             bool blanked) {
+  if (data->observer_)
+    data->observer_->OnWindowBlanked(handle, blanked);
+}
+
 void
 EventConverterInProcess::NotifyCommit(EventConverterInProcess* data,
                                       unsigned handle,
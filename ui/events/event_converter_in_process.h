@@ -6,12 +6,15 @@
 #define OZONE_UI_EVENTS_EVENT_CONVERTER_IN_PROCESS_H_
 
 #include <string>
+#include <vector>
 
 #include "base/memory/scoped_ptr.h"
 #include "ozone/ui/events/event_converter_ozone_wayland.h"
-#include "ozone/ui/events/keyboard_code_conversion_ozone.h"
+#include "ozone/ui/events/resolved_key_event.h"
+#include "ozone/ui/events/touch_update.h"
 #include "ui/events/event.h"
 #include "ui/events/platform/platform_event_source.h"
+#include "ui/gfx/point_f.h"
 
 namespace ui {
 
@@ -21,32 +24,40 @@ class EventConverterInProcess : public ui::EventConverterOzoneWayland,
   EventConverterInProcess();
   virtual ~EventConverterInProcess();
 
-  virtual void MotionNotify(float x, float y) OVERRIDE;
+  virtual void MotionNotify(float x, float y, uint32_t time_stamp) OVERRIDE;
   virtual void ButtonNotify(unsigned handle,
                             ui::EventType type,
                             ui::EventFlags flags,
                             float x,
-                            float y) OVERRIDE;
+                            float y,
+                            uint32_t time_stamp) OVERRIDE;
   virtual void AxisNotify(float x,
                           float y,
                           int xoffset,
-                          int yoffset) OVERRIDE;
+                          int yoffset,
+                          uint32_t time_stamp) OVERRIDE;
+  virtual void ScrollNotify(ui::EventType type,
+                            float x,
+                            float y,
+                            float x_offset,
+                            float y_offset,
+                            uint32_t time_stamp) OVERRIDE;
+  virtual void RelativeMotionNotify(float dx,
+                                    float dy,
+                                    uint32_t time_stamp) OVERRIDE;
   virtual void PointerEnter(unsigned handle, float x, float y) OVERRIDE;
   virtual void PointerLeave(unsigned handle, float x, float y) OVERRIDE;
-  virtual void KeyNotify(ui::EventType type,
-                         unsigned code,
-                         unsigned modifiers) OVERRIDE;
-  virtual void TouchNotify(ui::EventType type,
-                           float x,
-                           float y,
-                           int32_t touch_id,
-                           uint32_t time_stamp) OVERRIDE;
+  virtual void KeyNotify(const ui::ResolvedKeyEvent& event) OVERRIDE;
+  virtual void TouchFrameNotify(
+      const std::vector<ui::TouchUpdate>& updates) OVERRIDE;
   virtual void CloseWidget(unsigned handle) OVERRIDE;
 
   virtual void OutputSizeChanged(unsigned width, unsigned height) OVERRIDE;
   virtual void WindowResized(unsigned windowhandle,
                              unsigned width,
                              unsigned height) OVERRIDE;
+  virtual void WindowBlanked(unsigned windowhandle, bool blanked) OVERRIDE;
+  virtual void ImageCursorMissing(uint32 hash) OVERRIDE;
 
   virtual void Commit(unsigned handle, const std::string& text) OVERRIDE;
   virtual void PreeditChanged(unsigned handle, const std::string& text,
@@ -67,18 +78,32 @@ class EventConverterInProcess : public ui::EventConverterOzoneWayland,
   virtual void OnDispatcherListChanged() OVERRIDE;
   static void NotifyMotion(EventConverterInProcess* data,
                            float x,
-                           float y);
+                           float y,
+                           uint32_t time_stamp);
   static void NotifyButtonPress(EventConverterInProcess* data,
                                 unsigned handle,
                                 ui::EventType type,
                                 ui::EventFlags flags,
                                 float x,
-                                float y);
+                                float y,
+                                uint32_t time_stamp);
   static void NotifyAxis(EventConverterInProcess* data,
                          float x,
                          float y,
                          int xoffset,
-                         int yoffset);
+                         int yoffset,
+                         uint32_t time_stamp);
+  static void NotifyScroll(EventConverterInProcess* data,
+                           ui::EventType type,
+                           float x,
+                           float y,
+                           float x_offset,
+                           float y_offset,
+                           uint32_t time_stamp);
+  static void NotifyRelativeMotion(EventConverterInProcess* data,
+                                   float dx,
+                                   float dy,
+                                   uint32_t time_stamp);
   static void NotifyPointerEnter(EventConverterInProcess* data,
                                  unsigned handle,
                                  float x,
@@ -88,16 +113,9 @@ class EventConverterInProcess : public ui::EventConverterOzoneWayland,
                                  float x,
                                  float y);
   static void NotifyKeyEvent(EventConverterInProcess* data,
-                             ui::EventType type,
-                             ui::KeyboardCode code,
-                             uint16 CharacterCodeFromNativeKey,
-                             unsigned modifiers);
-  static void NotifyTouchEvent(EventConverterInProcess* data,
-                               ui::EventType type,
-                               float x,
-                               float y,
-                               int32_t touch_id,
-                               uint32_t time_stamp);
+                             const ui::ResolvedKeyEvent& event);
+  static void NotifyTouchFrame(EventConverterInProcess* data,
+                               const std::vector<ui::TouchUpdate>& updates);
   static void NotifyCloseWidget(EventConverterInProcess* data,
                                 unsigned handle);
   static void NotifyOutputSizeChanged(EventConverterInProcess* data,
@@ -107,6 +125,9 @@ class EventConverterInProcess : public ui::EventConverterOzoneWayland,
                                   unsigned handle,
                                   unsigned width,
                                   unsigned height);
+  static void NotifyWindowBlanked(EventConverterInProcess* data,
+                                  unsigned handle,
+                                  bool blanked);
   static void NotifyCommit(EventConverterInProcess* data, unsigned handle,
                            const std::string& text);
   static void NotifyPreeditChanged(EventConverterInProcess* data,
@@ -121,6 +142,8 @@ class EventConverterInProcess : public ui::EventConverterOzoneWayland,
 
   ui::WindowChangeObserver* observer_;
   ui::OutputChangeObserver* output_observer_;
+  // Location of the last mouse motion, which relative motion moves on from.
+  gfx::PointF pointer_location_;
   base::Callback<void(void*)> dispatch_callback_;  // NOLINT(readability/
                                                    // function)
   DISALLOW_COPY_AND_ASSIGN(EventConverterInProcess);
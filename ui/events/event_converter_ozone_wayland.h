@@ -6,6 +6,7 @@
 #define OZONE_UI_EVENTS_EVENT_CONVERTER_OZONE_WAYLAND_H_
 
 #include <string>
+#include <vector>
 
 #include "base/message_loop/message_loop.h"
 #include "ozone/platform/ozone_export_wayland.h"
@@ -15,6 +16,8 @@ namespace ui {
 
 class WindowChangeObserver;
 class OutputChangeObserver;
+struct ResolvedKeyEvent;
+struct TouchUpdate;
 
 // In OzoneWayland, Chrome relies on Wayland protocol to recieve callback of
 // any input/surface events. This class is responsible for the following:
@@ -26,28 +29,48 @@ class OZONE_WAYLAND_EXPORT EventConverterOzoneWayland {
   EventConverterOzoneWayland();
   virtual ~EventConverterOzoneWayland();
 
-  virtual void MotionNotify(float x, float y) = 0;
+  // |time_stamp| arguments are the compositor's event time, in milliseconds.
+
+  virtual void MotionNotify(float x, float y, uint32_t time_stamp) = 0;
   virtual void ButtonNotify(unsigned handle,
                             EventType type,
                             EventFlags flags,
                             float x,
-                            float y) = 0;
-  virtual void AxisNotify(float x, float y, int xoffset, int yoffset) = 0;
+                            float y,
+                            uint32_t time_stamp) = 0;
+  virtual void AxisNotify(float x,
+                          float y,
+                          int xoffset,
+                          int yoffset,
+                          uint32_t time_stamp) = 0;
+  // Smooth scrolling, from touchpads and the like. |type| is ET_SCROLL with
+  // the distance scrolled in pixels, ET_SCROLL_FLING_START with the velocity
+  // in pixels per second, or ET_SCROLL_FLING_CANCEL.
+  virtual void ScrollNotify(EventType type,
+                            float x,
+                            float y,
+                            float x_offset,
+                            float y_offset,
+                            uint32_t time_stamp) = 0;
+  // Unaccelerated motion of a locked pointer, which has no position of its
+  // own, since the last motion.
+  virtual void RelativeMotionNotify(float dx, float dy,
+                                    uint32_t time_stamp) = 0;
   virtual void PointerEnter(unsigned handle, float x, float y) = 0;
   virtual void PointerLeave(unsigned handle, float x, float y) = 0;
-  virtual void KeyNotify(ui::EventType type,
-                         unsigned code,
-                         unsigned modifiers) = 0;
-  virtual void TouchNotify(ui::EventType type,
-                           float x,
-                           float y,
-                           int32_t touch_id,
-                           uint32_t time_stamp) = 0;
+  virtual void KeyNotify(const ResolvedKeyEvent& event) = 0;
+  // Delivers the touch points that changed in one wl_touch frame, in the
+  // order the changes happened.
+  virtual void TouchFrameNotify(const std::vector<TouchUpdate>& updates) = 0;
 
   virtual void OutputSizeChanged(unsigned width, unsigned height) = 0;
   virtual void WindowResized(unsigned windowhandle,
                              unsigned width,
                              unsigned height) = 0;
+  // Nothing of the window can be seen while it is |blanked|.
+  virtual void WindowBlanked(unsigned windowhandle, bool blanked) = 0;
+  // The image cursor |hash| was set without its bitmap, but isn't cached.
+  virtual void ImageCursorMissing(uint32 hash) = 0;
   virtual void CloseWidget(unsigned handle) = 0;
   virtual void Commit(unsigned handle, const std::string& text) = 0;
   virtual void PreeditChanged(unsigned handle, const std::string& text,
@@ -33,7 +33,7 @@ KeyboardCode KeyboardCodeFromNativeKeysym(unsigned keysym) {
   if (keysym == OZONECHARCODE_NULL)
     return VKEY_UNKNOWN;
 
-  DLOG(WARNING) << "Unknown keysym: " << base::StringPrintf("0x%x", keysym);
+  DVLOG(1) << "Unknown keysym: " << base::StringPrintf("0x%x", keysym);
   return VKEY_UNKNOWN;
 }
 
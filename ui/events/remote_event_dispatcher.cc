@@ -22,23 +22,44 @@ void RemoteEventDispatcher::ChannelEstablished(IPC::Sender* sender) {
   sender_ = sender;
 }
 
-void RemoteEventDispatcher::MotionNotify(float x, float y) {
-  Dispatch(new WaylandInput_MotionNotify(x, y));
+void RemoteEventDispatcher::MotionNotify(float x,
+                                         float y,
+                                         uint32_t time_stamp) {
+  Dispatch(new WaylandInput_MotionNotify(x, y, time_stamp));
 }
 
 void RemoteEventDispatcher::ButtonNotify(unsigned handle,
                                          ui::EventType type,
                                          ui::EventFlags flags,
                                          float x,
-                                         float y) {
-  Dispatch(new WaylandInput_ButtonNotify(handle, type, flags, x, y));
+                                         float y,
+                                         uint32_t time_stamp) {
+  Dispatch(new WaylandInput_ButtonNotify(handle, type, flags, x, y,
+                                         time_stamp));
 }
 
 void RemoteEventDispatcher::AxisNotify(float x,
                                        float y,
                                        int xoffset,
-                                       int yoffset) {
-  Dispatch(new WaylandInput_AxisNotify(x, y, xoffset, yoffset));
+                                       int yoffset,
+                                       uint32_t time_stamp) {
+  Dispatch(new WaylandInput_AxisNotify(x, y, xoffset, yoffset, time_stamp));
+}
+
+void RemoteEventDispatcher::ScrollNotify(ui::EventType type,
+                                         float x,
+                                         float y,
+                                         float x_offset,
+                                         float y_offset,
+                                         uint32_t time_stamp) {
+  Dispatch(new WaylandInput_ScrollNotify(type, x, y, x_offset, y_offset,
+                                         time_stamp));
+}
+
+void RemoteEventDispatcher::RelativeMotionNotify(float dx,
+                                                 float dy,
+                                                 uint32_t time_stamp) {
+  Dispatch(new WaylandInput_RelativeMotionNotify(dx, dy, time_stamp));
 }
 
 void RemoteEventDispatcher::PointerEnter(unsigned handle,
@@ -53,18 +74,13 @@ void RemoteEventDispatcher::PointerLeave(unsigned handle,
   Dispatch(new WaylandInput_PointerLeave(handle, x, y));
 }
 
-void RemoteEventDispatcher::KeyNotify(ui::EventType type,
-                                      unsigned code,
-                                      unsigned modifiers) {
-  Dispatch(new WaylandInput_KeyNotify(type, code, modifiers));
+void RemoteEventDispatcher::KeyNotify(const ui::ResolvedKeyEvent& event) {
+  Dispatch(new WaylandInput_KeyNotify(event));
 }
 
-void RemoteEventDispatcher::TouchNotify(ui::EventType type,
-                                        float x,
-                                        float y,
-                                        int32_t touch_id,
-                                        uint32_t time_stamp) {
-  Dispatch(new WaylandInput_TouchNotify(type, x, y, touch_id, time_stamp));
+void RemoteEventDispatcher::TouchFrameNotify(
+    const std::vector<ui::TouchUpdate>& updates) {
+  Dispatch(new WaylandInput_TouchFrameNotify(updates));
 }
 
 void RemoteEventDispatcher::OutputSizeChanged(unsigned width,
@@ -78,6 +94,14 @@ void RemoteEventDispatcher::WindowResized(unsigned handle,
   Dispatch(new WaylandWindow_Resized(handle, width, height));
 }
 
+void RemoteEventDispatcher::WindowBlanked(unsigned handle, bool blanked) {
+  Dispatch(new WaylandWindow_Blanked(handle, blanked));
+}
+
+void RemoteEventDispatcher::ImageCursorMissing(uint32 hash) {
+  Dispatch(new WaylandWindow_ImageCursorMissing(hash));
+}
+
 void RemoteEventDispatcher::CloseWidget(unsigned handle) {
   Dispatch(new WaylandInput_CloseWidget(handle));
 }
@@ -6,6 +6,7 @@
 #define OZONE_UI_EVENTS_REMOTE_EVENT_DISPATCHER_H_
 
 #include <string>
+#include <vector>
 
 #include "ipc/ipc_sender.h"
 #include "ozone/ui/events/event_converter_ozone_wayland.h"
@@ -23,31 +24,39 @@ class RemoteEventDispatcher : public ui::EventConverterOzoneWayland {
 
   void ChannelEstablished(IPC::Sender* sender);
 
-  virtual void MotionNotify(float x, float y) OVERRIDE;
+  virtual void MotionNotify(float x, float y, uint32_t time_stamp) OVERRIDE;
   virtual void ButtonNotify(unsigned handle,
                             ui::EventType type,
                             ui::EventFlags flags,
                             float x,
-                            float y) OVERRIDE;
+                            float y,
+                            uint32_t time_stamp) OVERRIDE;
   virtual void AxisNotify(float x,
                           float y,
                           int xoffset,
-                          int yoffset) OVERRIDE;
+                          int yoffset,
+                          uint32_t time_stamp) OVERRIDE;
+  virtual void ScrollNotify(ui::EventType type,
+                            float x,
+                            float y,
+                            float x_offset,
+                            float y_offset,
+                            uint32_t time_stamp) OVERRIDE;
+  virtual void RelativeMotionNotify(float dx,
+                                    float dy,
+                                    uint32_t time_stamp) OVERRIDE;
   virtual void PointerEnter(unsigned handle, float x, float y) OVERRIDE;
   virtual void PointerLeave(unsigned handle, float x, float y) OVERRIDE;
-  virtual void KeyNotify(ui::EventType type,
-                         unsigned code,
-                         unsigned modifiers) OVERRIDE;
-  virtual void TouchNotify(ui::EventType type,
-                           float x,
-                           float y,
-                           int32_t touch_id,
-                           uint32_t time_stamp) OVERRIDE;
+  virtual void KeyNotify(const ui::ResolvedKeyEvent& event) OVERRIDE;
+  virtual void TouchFrameNotify(
+      const std::vector<ui::TouchUpdate>& updates) OVERRIDE;
 
   virtual void OutputSizeChanged(unsigned width, unsigned height) OVERRIDE;
   virtual void WindowResized(unsigned handle,
                              unsigned width,
                              unsigned height) OVERRIDE;
+  virtual void WindowBlanked(unsigned handle, bool blanked) OVERRIDE;
+  virtual void ImageCursorMissing(uint32 hash) OVERRIDE;
   virtual void CloseWidget(unsigned handle) OVERRIDE;
 
   virtual void Commit(unsigned handle, const std::string& text) OVERRIDE;
@@ -6,11 +6,13 @@
 
 #include "ipc/ipc_sender.h"
 #include "ozone/ui/public/messages.h"
+#include "ui/gfx/geometry/size.h"
 
 namespace ui {
 
 RemoteStateChangeHandler::RemoteStateChangeHandler()
-    : sender_(NULL) {
+    : sender_(NULL),
+      image_cursor_hash_(0) {
   WindowStateChangeHandler::SetInstance(this);
   IMEStateChangeHandler::SetInstance(this);
 }
@@ -30,6 +32,19 @@ void RemoteStateChangeHandler::ChannelEstablished(IPC::Sender* sender) {
 
 void RemoteStateChangeHandler::ChannelDestroyed() {
   sender_ = NULL;
+  // A new GPU process starts without any image.
+  sent_image_cursors_.clear();
+}
+
+void RemoteStateChangeHandler::ImageCursorMissing(uint32 hash) {
+  // Images set before the last one were replaced already.
+  if (hash != image_cursor_hash_)
+    return;
+
+  sent_image_cursors_.insert(hash);
+  Send(new WaylandWindow_ImageCursor(hash,
+                                     image_cursor_bitmap_,
+                                     image_cursor_hotspot_));
 }
 
 void RemoteStateChangeHandler::SetWidgetState(unsigned w,
@@ -45,9 +60,46 @@ void RemoteStateChangeHandler::SetWidgetTitle(unsigned w,
 }
 
 void RemoteStateChangeHandler::SetWidgetCursor(int cursor_type) {
+  image_cursor_hash_ = 0;
+  image_cursor_bitmap_.reset();
   Send(new WaylandWindow_Cursor(cursor_type));
 }
 
+void RemoteStateChangeHandler::SetWidgetImageCursor(
+    uint32 hash,
+    const SkBitmap& bitmap,
+    const gfx::Point& hotspot) {
+  image_cursor_hash_ = hash;
+  image_cursor_bitmap_ = bitmap;
+  image_cursor_hotspot_ = hotspot;
+  // Only the first time an image is set is its bitmap sent. Should the GPU
+  // process have evicted it since, it asks for it with ImageCursorMissing().
+  if (!sent_image_cursors_.insert(hash).second) {
+    SetWidgetCachedImageCursor(hash,
+                               gfx::Size(bitmap.width(), bitmap.height()),
+                               hotspot);
+    return;
+  }
+
+  Send(new WaylandWindow_ImageCursor(hash, bitmap, hotspot));
+}
+
+void RemoteStateChangeHandler::SetWidgetCachedImageCursor(
+    uint32 hash,
+    const gfx::Size& size,
+    const gfx::Point& hotspot) {
+  Send(new WaylandWindow_CachedImageCursor(hash, size, hotspot));
+}
+
+void RemoteStateChangeHandler::SetWidgetOpaque(unsigned widget, bool opaque) {
+  Send(new WaylandWindow_Opaque(widget, opaque));
+}
+
+void RemoteStateChangeHandler::SetWidgetPointerConstraint(
+    unsigned widget, ui::PointerConstraint constraint) {
+  Send(new WaylandWindow_PointerConstraint(widget, constraint));
+}
+
 void RemoteStateChangeHandler::SetWidgetAttributes(unsigned widget,
                                                    unsigned parent,
                                                    unsigned x,
@@ -7,8 +7,11 @@
 
 #include <queue>
 
+#include "base/containers/hash_tables.h"
 #include "ozone/ui/events/ime_state_change_handler.h"
 #include "ozone/ui/events/window_state_change_handler.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/point.h"
 
 namespace IPC {
 class Message;
@@ -29,6 +32,9 @@ class RemoteStateChangeHandler : public ui::WindowStateChangeHandler,
 
   void ChannelEstablished(IPC::Sender* sender);
   void ChannelDestroyed();
+  // Called when the GPU process no longer has the image cursor |hash| it was
+  // asked to show.
+  void ImageCursorMissing(uint32 hash);
 
   // WindowStateChangeHandler implementation:
   virtual void SetWidgetState(unsigned widget,
@@ -38,6 +44,15 @@ class RemoteStateChangeHandler : public ui::WindowStateChangeHandler,
   virtual void SetWidgetTitle(unsigned w,
                               const base::string16& title) OVERRIDE;
   virtual void SetWidgetCursor(int cursor_type) OVERRIDE;
+  virtual void SetWidgetImageCursor(uint32 hash,
+                                    const SkBitmap& bitmap,
+                                    const gfx::Point& hotspot) OVERRIDE;
+  virtual void SetWidgetCachedImageCursor(uint32 hash,
+                                          const gfx::Size& size,
+                                          const gfx::Point& hotspot) OVERRIDE;
+  virtual void SetWidgetOpaque(unsigned widget, bool opaque) OVERRIDE;
+  virtual void SetWidgetPointerConstraint(
+      unsigned widget, ui::PointerConstraint constraint) OVERRIDE;
   virtual void SetWidgetAttributes(unsigned widget,
                                    unsigned parent,
                                    unsigned x,
@@ -55,6 +70,13 @@ class RemoteStateChangeHandler : public ui::WindowStateChangeHandler,
   // Messages are not sent by host until connection is established. Host queues
   // all these messages to send after connection is established.
   DeferredMessages deferred_messages_;
+  // Image cursors sent to the GPU process, which keeps them.
+  base::hash_set<uint32> sent_image_cursors_;
+  // The image cursor set last, if it is still set, in case the GPU process
+  // evicted it.
+  uint32 image_cursor_hash_;
+  SkBitmap image_cursor_bitmap_;
+  gfx::Point image_cursor_hotspot_;
   DISALLOW_COPY_AND_ASSIGN(RemoteStateChangeHandler);
 };
 
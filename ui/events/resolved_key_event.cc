@@ -0,0 +1,37 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ozone/ui/events/resolved_key_event.h"
+
+#include "ozone/ui/events/keyboard_code_conversion_ozone.h"
+
+namespace ui {
+
+ResolvedKeyEvent::ResolvedKeyEvent()
+    : type(ET_UNKNOWN),
+      key_code(VKEY_UNKNOWN),
+      character(0),
+      flags(0),
+      time_stamp(0),
+      seat_id(0) {
+}
+
+ResolvedKeyEvent::~ResolvedKeyEvent() {
+}
+
+// static
+ResolvedKeyEvent ResolvedKeyEvent::FromKeysym(EventType type,
+                                              unsigned keysym,
+                                              int flags,
+                                              uint32 time_stamp) {
+  ResolvedKeyEvent event;
+  event.type = type;
+  event.key_code = KeyboardCodeFromNativeKeysym(keysym);
+  event.character = CharacterCodeFromNativeKeySym(keysym, flags);
+  event.flags = flags;
+  event.time_stamp = time_stamp;
+  return event;
+}
+
+}  // namespace ui
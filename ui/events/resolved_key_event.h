@@ -0,0 +1,46 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OZONE_UI_EVENTS_RESOLVED_KEY_EVENT_H_
+#define OZONE_UI_EVENTS_RESOLVED_KEY_EVENT_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "ozone/platform/ozone_export_wayland.h"
+#include "ui/events/event_constants.h"
+#include "ui/events/keycodes/keyboard_codes.h"
+
+namespace ui {
+
+// A key event translated with the keymap, on the thread receiving Wayland
+// events. Dispatchers create a ui::KeyEvent out of it as is, whether in the
+// same process or on the other end of the IPC channel.
+struct OZONE_WAYLAND_EXPORT ResolvedKeyEvent {
+  ResolvedKeyEvent();
+  ~ResolvedKeyEvent();
+
+  // Resolves an Ozone keysym without the help of a keymap. Used for input
+  // methods, which send keysyms rather than key codes.
+  static ResolvedKeyEvent FromKeysym(EventType type,
+                                     unsigned keysym,
+                                     int flags,
+                                     uint32 time_stamp);
+
+  EventType type;
+  KeyboardCode key_code;
+  // DOM |code| of the physical key, empty when unknown.
+  std::string code;
+  uint16 character;
+  int flags;
+  // Compositor time of the event, in milliseconds. 0 when unknown, e.g. for
+  // key repeats.
+  uint32 time_stamp;
+  // Seat the key belongs to, 0 when unknown.
+  uint32 seat_id;
+};
+
+}  // namespace ui
+
+#endif  // OZONE_UI_EVENTS_RESOLVED_KEY_EVENT_H_
@@ -0,0 +1,36 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OZONE_UI_EVENTS_TOUCH_UPDATE_H_
+#define OZONE_UI_EVENTS_TOUCH_UPDATE_H_
+
+#include "base/basictypes.h"
+#include "ui/events/event_constants.h"
+
+namespace ui {
+
+// The change of one touch point within a frame of touch events.
+struct TouchUpdate {
+  TouchUpdate()
+      : type(ET_UNKNOWN),
+        x(0),
+        y(0),
+        touch_id(0),
+        time_stamp(0),
+        seat_id(0) {
+  }
+
+  EventType type;
+  float x;
+  float y;
+  // Unique among the touch points down, across seats.
+  int32_t touch_id;
+  // Compositor time of the event, in milliseconds.
+  uint32_t time_stamp;
+  uint32_t seat_id;
+};
+
+}  // namespace ui
+
+#endif  // OZONE_UI_EVENTS_TOUCH_UPDATE_H_
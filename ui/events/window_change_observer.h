@@ -28,6 +28,9 @@ class OZONE_WAYLAND_EXPORT WindowChangeObserver {
   virtual void OnWindowResized(unsigned windowhandle,
                                unsigned width,
                                unsigned height) = 0;
+  // Called when a window gets blanked, because the output showing it was
+  // powered off, or unblanked.
+  virtual void OnWindowBlanked(unsigned windowhandle, bool blanked) = 0;
   // FIXME(joone): Move to IMEChangeObserver?
   virtual void OnPreeditChanged(unsigned handle,
                                 const std::string& text,
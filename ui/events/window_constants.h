@@ -29,6 +29,13 @@ namespace ui {
       // (i.e. Wayland install the grab) by the Window.
   };
 
+  enum PointerConstraint {
+    POINTER_UNCONSTRAINED = 0,  // The pointer moves freely.
+    POINTER_LOCKED = 1,  // The pointer stays in place over the Widget and
+      // only reports relative motion.
+    POINTER_CONFINED = 2  // The pointer can't leave the Widget.
+  };
+
 }  // namespace ui
 
 #endif  // OZONE_UI_EVENTS_WINDOW_CONSTANTS_H_
@@ -10,6 +10,13 @@
 #include "ozone/platform/ozone_export_wayland.h"
 #include "ozone/ui/events/window_constants.h"
 
+class SkBitmap;
+
+namespace gfx {
+class Point;
+class Size;
+}
+
 namespace ui {
 
 // A simple interface for passing Window state change notifications coming from
@@ -35,6 +42,25 @@ class OZONE_WAYLAND_EXPORT WindowStateChangeHandler {
   virtual void SetWidgetTitle(unsigned widget, const base::string16& title) = 0;
   // Called when Cursor has changed and the image needs to be updated.
   virtual void SetWidgetCursor(int cursor_type) = 0;
+  // Called when an image cursor is set. |hash| identifies the contents of
+  // |bitmap| and |hotspot|, so the image only needs to be uploaded once.
+  virtual void SetWidgetImageCursor(uint32 hash,
+                                    const SkBitmap& bitmap,
+                                    const gfx::Point& hotspot) = 0;
+  // Called when an image cursor handed to SetWidgetImageCursor() before is
+  // set again, without its bitmap.
+  virtual void SetWidgetCachedImageCursor(uint32 hash,
+                                          const gfx::Size& size,
+                                          const gfx::Point& hotspot) = 0;
+
+  // Called when it is known whether the contents of AcceleratedWidget widget
+  // are fully opaque, so the compositor can skip blending them.
+  virtual void SetWidgetOpaque(unsigned widget, bool opaque) = 0;
+
+  // Called when the pointer should be locked or confined to AcceleratedWidget
+  // widget, e.g. for Pointer Lock, or released again.
+  virtual void SetWidgetPointerConstraint(
+      unsigned widget, ui::PointerConstraint constraint) = 0;
 
   // This is called when we want to create an AcceleratedWidget widget.
   virtual void SetWidgetAttributes(unsigned widget,
@@ -5,6 +5,7 @@
 // Multiply-included message file, hence no include guard here.
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/strings/string16.h"
@@ -12,9 +13,15 @@
 #include "ipc/ipc_message_utils.h"
 #include "ipc/ipc_param_traits.h"
 #include "ipc/param_traits_macros.h"
+#include "ozone/ui/events/resolved_key_event.h"
+#include "ozone/ui/events/touch_update.h"
 #include "ozone/ui/events/window_constants.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/events/event_constants.h"
+#include "ui/events/keycodes/keyboard_codes.h"
+#include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
 #include "ui/gfx/ipc/gfx_param_traits.h"
 
 
@@ -28,30 +35,65 @@ IPC_ENUM_TRAITS_MAX_VALUE(ui::WidgetState,
                           ui::DESTROYED)
 IPC_ENUM_TRAITS_MAX_VALUE(ui::WidgetType,
                           ui::POPUP)
-
-IPC_MESSAGE_CONTROL2(WaylandInput_MotionNotify,  // NOLINT(readability/fn_size)
+IPC_ENUM_TRAITS_MAX_VALUE(ui::PointerConstraint,
+                          ui::POINTER_CONFINED)
+IPC_ENUM_TRAITS_MAX_VALUE(ui::KeyboardCode,
+                          ui::VKEY_OEM_CLEAR)
+
+IPC_STRUCT_TRAITS_BEGIN(ui::ResolvedKeyEvent)
+  IPC_STRUCT_TRAITS_MEMBER(type)
+  IPC_STRUCT_TRAITS_MEMBER(key_code)
+  IPC_STRUCT_TRAITS_MEMBER(code)
+  IPC_STRUCT_TRAITS_MEMBER(character)
+  IPC_STRUCT_TRAITS_MEMBER(flags)
+  IPC_STRUCT_TRAITS_MEMBER(time_stamp)
+  IPC_STRUCT_TRAITS_MEMBER(seat_id)
+IPC_STRUCT_TRAITS_END()
+
+IPC_STRUCT_TRAITS_BEGIN(ui::TouchUpdate)
+  IPC_STRUCT_TRAITS_MEMBER(type)
+  IPC_STRUCT_TRAITS_MEMBER(x)
+  IPC_STRUCT_TRAITS_MEMBER(y)
+  IPC_STRUCT_TRAITS_MEMBER(touch_id)
+  IPC_STRUCT_TRAITS_MEMBER(time_stamp)
+  IPC_STRUCT_TRAITS_MEMBER(seat_id)
+IPC_STRUCT_TRAITS_END()
+
+IPC_MESSAGE_CONTROL3(WaylandInput_MotionNotify,  // NOLINT(readability/fn_size)
                      float /*x*/,
-                     float /*y*/)
+                     float /*y*/,
+                     uint32_t /*time_stamp*/)
 
-IPC_MESSAGE_CONTROL5(WaylandInput_ButtonNotify,  // NOLINT(readability/fn_size)
+IPC_MESSAGE_CONTROL6(WaylandInput_ButtonNotify,  // NOLINT(readability/fn_size)
                      unsigned /*handle*/,
                      ui::EventType /*type*/,
                      ui::EventFlags /*flags*/,
                      float /*x*/,
-                     float /*y*/)
+                     float /*y*/,
+                     uint32_t /*time_stamp*/)
 
-IPC_MESSAGE_CONTROL5(WaylandInput_TouchNotify,  // NOLINT(readability/fn_size)
-                     ui::EventType /*type*/,
+IPC_MESSAGE_CONTROL1(WaylandInput_TouchFrameNotify,  // NOLINT(readability/
+                     std::vector<ui::TouchUpdate> /*updates*/)  // fn_size)
+
+IPC_MESSAGE_CONTROL5(WaylandInput_AxisNotify,  // NOLINT(readability/fn_size)
                      float /*x*/,
                      float /*y*/,
-                     int32_t /*touch_id*/,
+                     int /*x_offset*/,
+                     int /*y_offset*/,
                      uint32_t /*time_stamp*/)
 
-IPC_MESSAGE_CONTROL4(WaylandInput_AxisNotify,  // NOLINT(readability/fn_size)
+IPC_MESSAGE_CONTROL6(WaylandInput_ScrollNotify,  // NOLINT(readability/fn_size)
+                     ui::EventType /*type*/,
                      float /*x*/,
                      float /*y*/,
-                     int /*x_offset*/,
-                     int /*y_offset*/)
+                     float /*x_offset*/,
+                     float /*y_offset*/,
+                     uint32_t /*time_stamp*/)
+
+IPC_MESSAGE_CONTROL3(WaylandInput_RelativeMotionNotify,  // NOLINT(readability/
+                     float /*dx*/,                       // fn_size)
+                     float /*dy*/,
+                     uint32_t /*time_stamp*/)
 
 IPC_MESSAGE_CONTROL3(WaylandInput_PointerEnter,  // NOLINT(readability/fn_size)
                      unsigned /*handle*/,
@@ -63,10 +105,8 @@ IPC_MESSAGE_CONTROL3(WaylandInput_PointerLeave,  // NOLINT(readability/fn_size)
                      float /*x*/,
                      float /*y*/)
 
-IPC_MESSAGE_CONTROL3(WaylandInput_KeyNotify,  // NOLINT(readability/fn_size)
-                     ui::EventType /*type*/,
-                     unsigned /*code*/,
-                     unsigned /*modifiers*/)
+IPC_MESSAGE_CONTROL1(WaylandInput_KeyNotify,  // NOLINT(readability/fn_size)
+                     ui::ResolvedKeyEvent /*event*/)
 
 IPC_MESSAGE_CONTROL2(WaylandInput_OutputSize,  // NOLINT(readability/fn_size)
                      unsigned /*width*/,
@@ -80,6 +120,10 @@ IPC_MESSAGE_CONTROL3(WaylandWindow_Resized,  // NOLINT(readability/fn_size)
                      unsigned /* width */,
                      unsigned /* height */)
 
+IPC_MESSAGE_CONTROL2(WaylandWindow_Blanked,  // NOLINT(readability/fn_size)
+                     unsigned /* window handle */,
+                     bool /* blanked */)
+
 IPC_MESSAGE_CONTROL4(WaylandWindow_State,  // NOLINT(readability/fn_size)
                      unsigned /* window handle */,
                      ui::WidgetState /*state*/,
@@ -100,6 +144,27 @@ IPC_MESSAGE_CONTROL2(WaylandWindow_Title,  // NOLINT(readability/fn_size)
 IPC_MESSAGE_CONTROL1(WaylandWindow_Cursor,  // NOLINT(readability/fn_size)
                      int /* cursor type */)
 
+IPC_MESSAGE_CONTROL3(WaylandWindow_ImageCursor,  // NOLINT(readability/fn_size)
+                     uint32 /* hash */,
+                     SkBitmap /* bitmap */,
+                     gfx::Point /* hotspot */)
+
+IPC_MESSAGE_CONTROL3(WaylandWindow_CachedImageCursor,  // NOLINT(readability/
+                     uint32 /* hash */,                //         fn_size)
+                     gfx::Size /* size */,
+                     gfx::Point /* hotspot */)
+
+IPC_MESSAGE_CONTROL1(WaylandWindow_ImageCursorMissing,  // NOLINT(readability/
+                     uint32 /* hash */)                 //         fn_size)
+
+IPC_MESSAGE_CONTROL2(WaylandWindow_Opaque,  // NOLINT(readability/fn_size)
+                     unsigned /* window handle */,
+                     bool /* opaque */)
+
+IPC_MESSAGE_CONTROL2(WaylandWindow_PointerConstraint,  // NOLINT(readability/
+                     unsigned /* window handle */,      // fn_size)
+                     ui::PointerConstraint /* constraint */)
+
 IPC_MESSAGE_CONTROL0(WaylandWindow_ImeReset)  // NOLINT(readability/fn_size)
 
 IPC_MESSAGE_CONTROL1(WaylandWindow_ImeCaretBoundsChanged, // NOLINT(readability/
@@ -36,6 +36,12 @@ bool OzoneChannel::OnMessageReceived(const IPC::Message& message) {
   IPC_MESSAGE_HANDLER(WaylandWindow_Attributes, OnWidgetAttributesChanged)
   IPC_MESSAGE_HANDLER(WaylandWindow_Title, OnWidgetTitleChanged)
   IPC_MESSAGE_HANDLER(WaylandWindow_Cursor, OnWidgetCursorChanged)
+  IPC_MESSAGE_HANDLER(WaylandWindow_ImageCursor, OnWidgetImageCursorChanged)
+  IPC_MESSAGE_HANDLER(WaylandWindow_CachedImageCursor,
+                      OnWidgetCachedImageCursorChanged)
+  IPC_MESSAGE_HANDLER(WaylandWindow_Opaque, OnWidgetOpaqueChanged)
+  IPC_MESSAGE_HANDLER(WaylandWindow_PointerConstraint,
+                      OnWidgetPointerConstraintChanged)
   IPC_MESSAGE_HANDLER(WaylandWindow_ImeReset, OnWidgetImeReset)
   IPC_MESSAGE_HANDLER(WaylandWindow_ShowInputPanel, OnWidgetShowInputPanel)
   IPC_MESSAGE_HANDLER(WaylandWindow_HideInputPanel, OnWidgetHideInputPanel)
@@ -64,6 +70,32 @@ void OzoneChannel::OnWidgetCursorChanged(int cursor_type) {
   ui::WindowStateChangeHandler::GetInstance()->SetWidgetCursor(cursor_type);
 }
 
+void OzoneChannel::OnWidgetImageCursorChanged(uint32 hash,
+                                              const SkBitmap& bitmap,
+                                              const gfx::Point& hotspot) {
+  ui::WindowStateChangeHandler::GetInstance()->SetWidgetImageCursor(hash,
+                                                                    bitmap,
+                                                                    hotspot);
+}
+
+void OzoneChannel::OnWidgetCachedImageCursorChanged(
+    uint32 hash,
+    const gfx::Size& size,
+    const gfx::Point& hotspot) {
+  ui::WindowStateChangeHandler::GetInstance()->SetWidgetCachedImageCursor(
+      hash, size, hotspot);
+}
+
+void OzoneChannel::OnWidgetOpaqueChanged(unsigned widget, bool opaque) {
+  ui::WindowStateChangeHandler::GetInstance()->SetWidgetOpaque(widget, opaque);
+}
+
+void OzoneChannel::OnWidgetPointerConstraintChanged(
+    unsigned widget, ui::PointerConstraint constraint) {
+  ui::WindowStateChangeHandler::GetInstance()->SetWidgetPointerConstraint(
+      widget, constraint);
+}
+
 void OzoneChannel::OnWidgetAttributesChanged(unsigned widget,
                                              unsigned parent,
                                              unsigned x,
@@ -9,6 +9,13 @@
 #include "ozone/ui/events/window_constants.h"
 #include "ui/ozone/public/gpu_platform_support.h"
 
+class SkBitmap;
+
+namespace gfx {
+class Point;
+class Size;
+}
+
 namespace ui {
 class RemoteEventDispatcher;
 
@@ -28,6 +35,15 @@ class OzoneChannel : public GpuPlatformSupport {
                             unsigned height);
   void OnWidgetTitleChanged(unsigned widget, base::string16 title);
   void OnWidgetCursorChanged(int cursor_type);
+  void OnWidgetImageCursorChanged(uint32 hash,
+                                  const SkBitmap& bitmap,
+                                  const gfx::Point& hotspot);
+  void OnWidgetCachedImageCursorChanged(uint32 hash,
+                                        const gfx::Size& size,
+                                        const gfx::Point& hotspot);
+  void OnWidgetOpaqueChanged(unsigned widget, bool opaque);
+  void OnWidgetPointerConstraintChanged(unsigned widget,
+                                        ui::PointerConstraint constraint);
   void OnWidgetAttributesChanged(unsigned widget,
                                  unsigned parent,
                                  unsigned x,
@@ -48,14 +48,19 @@ bool OzoneChannelHost::OnMessageReceived(const IPC::Message& message) {
   IPC_BEGIN_MESSAGE_MAP(OzoneChannelHost, message)
   IPC_MESSAGE_HANDLER(WaylandInput_MotionNotify, OnMotionNotify)
   IPC_MESSAGE_HANDLER(WaylandInput_ButtonNotify, OnButtonNotify)
-  IPC_MESSAGE_HANDLER(WaylandInput_TouchNotify, OnTouchNotify)
+  IPC_MESSAGE_HANDLER(WaylandInput_TouchFrameNotify, OnTouchFrameNotify)
   IPC_MESSAGE_HANDLER(WaylandInput_AxisNotify, OnAxisNotify)
+  IPC_MESSAGE_HANDLER(WaylandInput_ScrollNotify, OnScrollNotify)
+  IPC_MESSAGE_HANDLER(WaylandInput_RelativeMotionNotify,
+                      OnRelativeMotionNotify)
   IPC_MESSAGE_HANDLER(WaylandInput_PointerEnter, OnPointerEnter)
   IPC_MESSAGE_HANDLER(WaylandInput_PointerLeave, OnPointerLeave)
   IPC_MESSAGE_HANDLER(WaylandInput_KeyNotify, OnKeyNotify)
   IPC_MESSAGE_HANDLER(WaylandInput_OutputSize, OnOutputSizeChanged)
   IPC_MESSAGE_HANDLER(WaylandInput_CloseWidget, OnCloseWidget)
   IPC_MESSAGE_HANDLER(WaylandWindow_Resized, OnWindowResized)
+  IPC_MESSAGE_HANDLER(WaylandWindow_Blanked, OnWindowBlanked)
+  IPC_MESSAGE_HANDLER(WaylandWindow_ImageCursorMissing, OnImageCursorMissing)
   IPC_MESSAGE_HANDLER(WaylandInput_Commit, OnCommit)
   IPC_MESSAGE_HANDLER(WaylandInput_PreeditChanged, OnPreeditChanged)
   IPC_MESSAGE_HANDLER(WaylandInput_PreeditEnd, OnPreeditEnd)
@@ -69,31 +74,45 @@ bool OzoneChannelHost::OnMessageReceived(const IPC::Message& message) {
   return handled;
 }
 
-void OzoneChannelHost::OnMotionNotify(float x, float y) {
-  event_converter_->MotionNotify(x, y);
+void OzoneChannelHost::OnMotionNotify(float x, float y, uint32_t time_stamp) {
+  event_converter_->MotionNotify(x, y, time_stamp);
 }
 
 void OzoneChannelHost::OnButtonNotify(unsigned handle,
                                       ui::EventType type,
                                       ui::EventFlags flags,
                                       float x,
-                                      float y) {
-  event_converter_->ButtonNotify(handle, type, flags, x, y);
+                                      float y,
+                                      uint32_t time_stamp) {
+  event_converter_->ButtonNotify(handle, type, flags, x, y, time_stamp);
 }
 
-void OzoneChannelHost::OnTouchNotify(ui::EventType type,
-                                     float x,
-                                     float y,
-                                     int32_t touch_id,
-                                     uint32_t time_stamp) {
-  event_converter_->TouchNotify(type, x, y, touch_id, time_stamp);
+void OzoneChannelHost::OnTouchFrameNotify(
+    const std::vector<ui::TouchUpdate>& updates) {
+  event_converter_->TouchFrameNotify(updates);
 }
 
 void OzoneChannelHost::OnAxisNotify(float x,
                                     float y,
                                     int xoffset,
-                                    int yoffset) {
-  event_converter_->AxisNotify(x, y, xoffset, yoffset);
+                                    int yoffset,
+                                    uint32_t time_stamp) {
+  event_converter_->AxisNotify(x, y, xoffset, yoffset, time_stamp);
+}
+
+void OzoneChannelHost::OnScrollNotify(ui::EventType type,
+                                      float x,
+                                      float y,
+                                      float x_offset,
+                                      float y_offset,
+                                      uint32_t time_stamp) {
+  event_converter_->ScrollNotify(type, x, y, x_offset, y_offset, time_stamp);
+}
+
+void OzoneChannelHost::OnRelativeMotionNotify(float dx,
+                                              float dy,
+                                              uint32_t time_stamp) {
+  event_converter_->RelativeMotionNotify(dx, dy, time_stamp);
 }
 
 void OzoneChannelHost::OnPointerEnter(unsigned handle,
@@ -108,10 +127,8 @@ void OzoneChannelHost::OnPointerLeave(unsigned handle,
   event_converter_->PointerLeave(handle, x, y);
 }
 
-void OzoneChannelHost::OnKeyNotify(ui::EventType type,
-                                   unsigned code,
-                                   unsigned modifiers) {
-  event_converter_->KeyNotify(type, code, modifiers);
+void OzoneChannelHost::OnKeyNotify(const ui::ResolvedKeyEvent& event) {
+  event_converter_->KeyNotify(event);
 }
 
 void OzoneChannelHost::OnOutputSizeChanged(unsigned width,
@@ -129,6 +146,15 @@ void OzoneChannelHost::OnWindowResized(unsigned handle,
   event_converter_->WindowResized(handle, width, height);
 }
 
+void OzoneChannelHost::OnWindowBlanked(unsigned handle, bool blanked) {
+  event_converter_->WindowBlanked(handle, blanked);
+}
+
+void OzoneChannelHost::OnImageCursorMissing(uint32 hash) {
+  if (state_handler_)
+    state_handler_->ImageCursorMissing(hash);
+}
+
 void OzoneChannelHost::OnCommit(unsigned handle, std::string text) {
   event_converter_->Commit(handle, text);
 }
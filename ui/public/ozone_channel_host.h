@@ -6,6 +6,7 @@
 #define OZONE_UI_PUBLIC_OZONE_CHANNEL_HOST_H_
 
 #include <string>
+#include <vector>
 
 #include "ui/events/event_constants.h"
 #include "ui/ozone/public/gpu_platform_support_host.h"
@@ -13,6 +14,8 @@
 namespace ui {
 class RemoteStateChangeHandler;
 class EventConverterInProcess;
+struct ResolvedKeyEvent;
+struct TouchUpdate;
 
 class OzoneChannelHost : public GpuPlatformSupportHost {
  public:
@@ -26,26 +29,36 @@ class OzoneChannelHost : public GpuPlatformSupportHost {
   virtual void OnChannelDestroyed(int host_id) OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message&) OVERRIDE;
 
-  void OnMotionNotify(float x, float y);
+  void OnMotionNotify(float x, float y, uint32_t time_stamp);
   void OnButtonNotify(unsigned handle,
                       ui::EventType type,
                       ui::EventFlags flags,
                       float x,
-                      float y);
-  void OnTouchNotify(ui::EventType type,
-                     float x,
-                     float y,
-                     int32_t touch_id,
-                     uint32_t time_stamp);
-  void OnAxisNotify(float x, float y, int xoffset, int yoffset);
+                      float y,
+                      uint32_t time_stamp);
+  void OnTouchFrameNotify(const std::vector<ui::TouchUpdate>& updates);
+  void OnAxisNotify(float x,
+                    float y,
+                    int xoffset,
+                    int yoffset,
+                    uint32_t time_stamp);
+  void OnScrollNotify(ui::EventType type,
+                      float x,
+                      float y,
+                      float x_offset,
+                      float y_offset,
+                      uint32_t time_stamp);
+  void OnRelativeMotionNotify(float dx, float dy, uint32_t time_stamp);
   void OnPointerEnter(unsigned handle, float x, float y);
   void OnPointerLeave(unsigned handle, float x, float y);
-  void OnKeyNotify(ui::EventType type, unsigned code, unsigned modifiers);
+  void OnKeyNotify(const ui::ResolvedKeyEvent& event);
   void OnOutputSizeChanged(unsigned width, unsigned height);
   void OnCloseWidget(unsigned handle);
   void OnWindowResized(unsigned handle,
                        unsigned width,
                        unsigned height);
+  void OnWindowBlanked(unsigned handle, bool blanked);
+  void OnImageCursorMissing(uint32 hash);
   void OnCommit(unsigned handle, std::string text);
   void OnPreeditChanged(unsigned handle, std::string text, std::string commit);
   void OnPreeditEnd();
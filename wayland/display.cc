@@ -8,7 +8,9 @@
 #include <EGL/egl.h>
 #include <string>
 
+#include "base/bind.h"
 #include "base/files/file_path.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "base/native_library.h"
 #include "base/stl_util.h"
 #include "ozone/ui/events/event_factory_ozone_wayland.h"
@@ -19,6 +21,8 @@
 #include "ozone/wayland/input_device.h"
 #include "ozone/wayland/screen.h"
 #include "ozone/wayland/shell/shell.h"
+#include "ozone/wayland/shell/shell_surface.h"
+#include "ozone/wayland/shm/surface_ozone_canvas_wayland.h"
 #include "ozone/wayland/window.h"
 
 namespace ozonewayland {
@@ -33,9 +37,13 @@ WaylandDisplay::WaylandDisplay() : SurfaceFactoryOzone(),
 #if defined(WEBOS)
     text_model_factory_(NULL),
 #endif
+    relative_pointer_manager_(NULL),
+    pointer_constraints_(NULL),
+    output_power_manager_(NULL),
     primary_screen_(NULL),
     look_ahead_screen_(NULL),
-    primary_input_(NULL),
+    active_input_(NULL),
+    ime_input_(NULL),
     display_poll_thread_(NULL),
     screen_list_(),
     input_list_(),
@@ -52,6 +60,52 @@ const std::list<WaylandScreen*>& WaylandDisplay::GetScreenList() const {
   return screen_list_;
 }
 
+WaylandScreen* WaylandDisplay::GetScreen(wl_output* output) const {
+  for (std::list<WaylandScreen*>::const_iterator i = screen_list_.begin();
+       i != screen_list_.end(); ++i) {
+    if ((*i)->GetOutput() == output)
+      return *i;
+  }
+
+  return NULL;
+}
+
+void WaylandDisplay::OnOutputPowerChanged(WaylandScreen* screen,
+                                          bool powered_on) {
+  PostTaskOnGpuThread(base::Bind(&WaylandDisplay::SetOutputPowered,
+                                 base::Unretained(this),
+                                 screen,
+                                 powered_on));
+}
+
+void WaylandDisplay::OnWindowOutputChanged(unsigned w,
+                                           wl_output* output,
+                                           bool entered) {
+  // |screen_list_| changes on this thread.
+  WaylandScreen* screen = GetScreen(output);
+  if (!screen)
+    return;
+
+  PostTaskOnGpuThread(base::Bind(&WaylandDisplay::SetWindowOnScreen,
+                                 base::Unretained(this),
+                                 w,
+                                 screen,
+                                 entered));
+}
+
+void WaylandDisplay::OnWindowShellHidden(unsigned w, bool hidden) {
+  PostTaskOnGpuThread(base::Bind(&WaylandDisplay::SetWindowShellHidden,
+                                 base::Unretained(this),
+                                 w,
+                                 hidden));
+}
+
+void WaylandDisplay::OnWindowConfigureDeferred(unsigned w) {
+  PostTaskOnGpuThread(base::Bind(&WaylandDisplay::FlushWindowConfigure,
+                                 base::Unretained(this),
+                                 w));
+}
+
 WaylandWindow* WaylandDisplay::GetWindow(unsigned window_handle) const {
   return GetWidget(window_handle);
 }
@@ -66,12 +120,27 @@ struct wl_text_input_manager* WaylandDisplay::GetTextInputManager() const {
 }
 #endif
 
+WaylandInputDevice* WaylandDisplay::ActiveInput() const {
+  base::AutoLock auto_lock(active_input_lock_);
+  return active_input_;
+}
+
+void WaylandDisplay::SetActiveInput(WaylandInputDevice* input) {
+  base::AutoLock auto_lock(active_input_lock_);
+  active_input_ = input;
+}
+
+void WaylandDisplay::SetImeInput(WaylandInputDevice* input) {
+  base::AutoLock auto_lock(ime_lock_);
+  ime_input_ = input;
+}
+
 void WaylandDisplay::FlushDisplay() {
   wl_display_flush(display_);
 }
 
 void WaylandDisplay::DestroyWindow(unsigned w) {
-  std::map<unsigned, WaylandWindow*>::const_iterator it = widget_map_.find(w);
+  WindowMap::const_iterator it = widget_map_.find(w);
   WaylandWindow* widget = it == widget_map_.end() ? NULL : it->second;
   DCHECK(widget);
   delete widget;
@@ -80,14 +149,13 @@ void WaylandDisplay::DestroyWindow(unsigned w) {
     StopProcessingEvents();
 }
 
-gfx::AcceleratedWidget WaylandDisplay::GetNativeWindow(unsigned window_handle) {
+gfx::AcceleratedWidget WaylandDisplay::GetNativeWindow(WaylandWindow* window) {
   // Ensure we are processing wayland event requests.
   StartProcessingEvents();
-  WaylandWindow* widget = GetWidget(window_handle);
-  DCHECK(widget);
-  widget->RealizeAcceleratedWidget();
+  DCHECK(window);
+  window->RealizeAcceleratedWidget();
 
-  return (gfx::AcceleratedWidget)widget->egl_window();
+  return (gfx::AcceleratedWidget)window->egl_window();
 }
 
 bool WaylandDisplay::InitializeHardware() {
@@ -106,7 +174,23 @@ intptr_t WaylandDisplay::GetNativeDisplay() {
 
 scoped_ptr<ui::SurfaceOzoneEGL> WaylandDisplay::CreateEGLSurfaceForWidget(
     gfx::AcceleratedWidget w) {
-  return make_scoped_ptr<ui::SurfaceOzoneEGL>(new SurfaceOzoneWayland(w));
+  WaylandWindow* window = GetWidget(w);
+  DCHECK(window);
+  return make_scoped_ptr<ui::SurfaceOzoneEGL>(new SurfaceOzoneWayland(window));
+}
+
+scoped_ptr<ui::SurfaceOzoneCanvas> WaylandDisplay::CreateCanvasForWidget(
+    gfx::AcceleratedWidget w) {
+  WaylandWindow* window = GetWidget(w);
+  if (!display_ || !shm_ || !window) {
+    LOG(ERROR) << "Software rendering is not available for widget " << w;
+    return scoped_ptr<ui::SurfaceOzoneCanvas>();
+  }
+
+  StartProcessingEvents();
+  window->RealizeShellSurface();
+  return make_scoped_ptr<ui::SurfaceOzoneCanvas>(
+      new SurfaceOzoneCanvasWayland(window));
 }
 
 bool WaylandDisplay::LoadEGLGLES2Bindings(
@@ -231,7 +315,87 @@ void WaylandDisplay::SetWidgetTitle(unsigned w,
 }
 
 void WaylandDisplay::SetWidgetCursor(int cursor_type) {
-  primary_input_->SetCursorType(cursor_type);
+  // Every seat with a pointer has a cursor of its own.
+  for (std::list<WaylandInputDevice*>::iterator i = input_list_.begin();
+       i != input_list_.end(); ++i) {
+    if ((*i)->GetPointer())
+      (*i)->SetCursorType(cursor_type);
+  }
+}
+
+void WaylandDisplay::SetWidgetImageCursor(uint32 hash,
+                                          const SkBitmap& bitmap,
+                                          const gfx::Point& hotspot) {
+  for (std::list<WaylandInputDevice*>::iterator i = input_list_.begin();
+       i != input_list_.end(); ++i) {
+    if ((*i)->GetPointer())
+      (*i)->SetCursorBitmap(hash, bitmap, hotspot);
+  }
+}
+
+void WaylandDisplay::SetWidgetCachedImageCursor(uint32 hash,
+                                                const gfx::Size& size,
+                                                const gfx::Point& hotspot) {
+  bool cached = true;
+  for (std::list<WaylandInputDevice*>::iterator i = input_list_.begin();
+       i != input_list_.end(); ++i) {
+    if ((*i)->GetPointer() &&
+        !(*i)->SetCachedCursorBitmap(hash, size, hotspot)) {
+      cached = false;
+    }
+  }
+
+  if (!cached) {
+    ui::EventFactoryOzoneWayland::GetInstance()->EventConverter()->
+        ImageCursorMissing(hash);
+  }
+}
+
+void WaylandDisplay::SetWidgetOpaque(unsigned w, bool opaque) {
+  WaylandWindow* widget = GetWidget(w);
+  DCHECK(widget);
+  widget->SetOpaque(opaque);
+}
+
+void WaylandDisplay::SetWidgetPointerConstraint(
+    unsigned w, ui::PointerConstraint constraint) {
+  WaylandWindow* widget = GetWidget(w);
+  DCHECK(widget);
+  switch (constraint) {
+    case ui::POINTER_LOCKED:
+      widget->LockPointer();
+      break;
+    case ui::POINTER_CONFINED:
+      widget->ConfinePointer();
+      break;
+    case ui::POINTER_UNCONSTRAINED:
+      widget->UnconstrainPointer();
+      break;
+  }
+}
+
+void WaylandDisplay::ResetIme() {
+  base::AutoLock auto_lock(ime_lock_);
+  if (ime_input_)
+    ime_input_->ResetIme();
+}
+
+void WaylandDisplay::ImeCaretBoundsChanged(gfx::Rect rect) {
+  base::AutoLock auto_lock(ime_lock_);
+  if (ime_input_)
+    ime_input_->ImeCaretBoundsChanged(rect);
+}
+
+void WaylandDisplay::ShowInputPanel() {
+  base::AutoLock auto_lock(ime_lock_);
+  if (ime_input_)
+    ime_input_->ShowInputPanel();
+}
+
+void WaylandDisplay::HideInputPanel() {
+  base::AutoLock auto_lock(ime_lock_);
+  if (ime_input_)
+    ime_input_->HideInputPanel();
 }
 
 void WaylandDisplay::SetWidgetAttributes(unsigned widget,
@@ -322,6 +486,7 @@ void WaylandDisplay::InitializeDisplay() {
     return;
 
   instance_ = this;
+  gpu_loop_ = base::MessageLoopProxy::current();
   static const struct wl_registry_listener registry_all = {
     WaylandDisplay::DisplayHandleGlobal
   };
@@ -336,6 +501,7 @@ void WaylandDisplay::InitializeDisplay() {
   }
 
   ui::WindowStateChangeHandler::SetInstance(this);
+  ui::IMEStateChangeHandler::SetInstance(this);
   display_poll_thread_ = new WaylandDisplayPollThread(display_);
 }
 
@@ -370,6 +536,11 @@ void WaylandDisplay::Terminate() {
     widget_map_.clear();
   }
 
+  {
+    base::AutoLock auto_lock(ime_lock_);
+    ime_input_ = NULL;
+  }
+
   for (std::list<WaylandInputDevice*>::iterator i = input_list_.begin();
       i != input_list_.end(); ++i) {
       delete *i;
@@ -382,6 +553,7 @@ void WaylandDisplay::Terminate() {
 
   screen_list_.clear();
   input_list_.clear();
+  SetActiveInput(NULL);
 
   WaylandCursor::Clear();
 
@@ -397,6 +569,15 @@ void WaylandDisplay::Terminate() {
     text_model_factory_destroy(text_model_factory_);
 #endif
 
+  if (relative_pointer_manager_)
+    zwp_relative_pointer_manager_v1_destroy(relative_pointer_manager_);
+
+  if (pointer_constraints_)
+    zwp_pointer_constraints_v1_destroy(pointer_constraints_);
+
+  if (output_power_manager_)
+    zwlr_output_power_manager_v1_destroy(output_power_manager_);
+
   if (registry_)
     wl_registry_destroy(registry_);
 
@@ -412,10 +593,54 @@ void WaylandDisplay::Terminate() {
 }
 
 WaylandWindow* WaylandDisplay::GetWidget(unsigned w) const {
-  std::map<unsigned, WaylandWindow*>::const_iterator it = widget_map_.find(w);
+  WindowMap::const_iterator it = widget_map_.find(w);
   return it == widget_map_.end() ? NULL : it->second;
 }
 
+void WaylandDisplay::PostTaskOnGpuThread(const base::Closure& task) {
+  if (gpu_loop_)
+    gpu_loop_->PostTask(FROM_HERE, task);
+}
+
+void WaylandDisplay::SetOutputPowered(WaylandScreen* screen,
+                                      bool powered_on) {
+  if (screen->IsPoweredOn() == powered_on)
+    return;
+
+  DVLOG(1) << "Output powered " << (powered_on ? "on" : "off");
+  screen->SetPoweredOn(powered_on);
+  for (WindowMap::const_iterator it = widget_map_.begin();
+       it != widget_map_.end(); ++it) {
+    it->second->OnOutputPowerChanged(screen);
+  }
+}
+
+void WaylandDisplay::SetWindowOnScreen(unsigned w,
+                                       WaylandScreen* screen,
+                                       bool entered) {
+  // The window may be gone by now.
+  WaylandWindow* window = GetWidget(w);
+  if (!window)
+    return;
+
+  if (entered)
+    window->EnterScreen(screen);
+  else
+    window->LeaveScreen(screen);
+}
+
+void WaylandDisplay::SetWindowShellHidden(unsigned w, bool hidden) {
+  WaylandWindow* window = GetWidget(w);
+  if (window)
+    window->SetShellHidden(hidden);
+}
+
+void WaylandDisplay::FlushWindowConfigure(unsigned w) {
+  WaylandWindow* window = GetWidget(w);
+  if (window && window->ShellSurface())
+    window->ShellSurface()->FlushPendingConfigure(window);
+}
+
 
 // static
 void WaylandDisplay::DisplayHandleGlobal(void *data,
@@ -431,6 +656,8 @@ void WaylandDisplay::DisplayHandleGlobal(void *data,
         wl_registry_bind(registry, name, &wl_compositor_interface, 1));
   } else if (strcmp(interface, "wl_output") == 0) {
     WaylandScreen* screen = new WaylandScreen(disp->registry(), name);
+    if (disp->output_power_manager_)
+      screen->BindOutputPower(disp->output_power_manager_);
     if (!disp->screen_list_.empty())
       NOTIMPLEMENTED() << "Multiple screens support is not implemented";
 
@@ -438,12 +665,38 @@ void WaylandDisplay::DisplayHandleGlobal(void *data,
     // (kalyan) Support extended output.
     disp->primary_screen_ = disp->screen_list_.front();
   } else if (strcmp(interface, "wl_seat") == 0) {
-    WaylandInputDevice *input_device = new WaylandInputDevice(disp, name);
+    WaylandInputDevice *input_device = new WaylandInputDevice(disp, name,
+                                                             version);
     disp->input_list_.push_back(input_device);
-    disp->primary_input_ = disp->input_list_.front();
+    if (!disp->ActiveInput())
+      disp->SetActiveInput(input_device);
+    // The first seat handles input methods until a keyboard gets focus.
+    base::AutoLock auto_lock(disp->ime_lock_);
+    if (!disp->ime_input_)
+      disp->ime_input_ = input_device;
   } else if (strcmp(interface, "wl_shm") == 0) {
     disp->shm_ = static_cast<wl_shm*>(
         wl_registry_bind(registry, name, &wl_shm_interface, 1));
+  } else if (strcmp(interface, "zwp_relative_pointer_manager_v1") == 0) {
+    disp->relative_pointer_manager_ =
+        static_cast<zwp_relative_pointer_manager_v1*>(wl_registry_bind(
+            registry, name, &zwp_relative_pointer_manager_v1_interface, 1));
+  } else if (strcmp(interface, "zwp_pointer_constraints_v1") == 0) {
+    disp->pointer_constraints_ =
+        static_cast<zwp_pointer_constraints_v1*>(wl_registry_bind(
+            registry, name, &zwp_pointer_constraints_v1_interface, 1));
+  } else if ((strcmp(interface, "zwlr_output_power_manager_v1") == 0) &&
+             getenv("OZONE_WAYLAND_WATCH_OUTPUT_POWER")) {
+    // The protocol grants control of the power of outputs, to one client per
+    // output. Only take it over where no power daemon uses it.
+    disp->output_power_manager_ =
+        static_cast<zwlr_output_power_manager_v1*>(wl_registry_bind(
+            registry, name, &zwlr_output_power_manager_v1_interface, 1));
+    // Outputs announced before the manager.
+    for (std::list<WaylandScreen*>::iterator i = disp->screen_list_.begin();
+         i != disp->screen_list_.end(); ++i) {
+      (*i)->BindOutputPower(disp->output_power_manager_);
+    }
   }
 #if defined(WEBOS)
     else if (strcmp(interface, "text_model_factory") == 0) {
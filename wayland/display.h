@@ -12,17 +12,29 @@
 
 #include <wayland-client.h>
 #include <list>
-#include <map>
 
 #include "base/basictypes.h"
+#include "base/callback_forward.h"
+#include "base/containers/hash_tables.h"
+#include "base/containers/small_map.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "ozone/ui/events/ime_state_change_handler.h"
 #include "ozone/ui/events/window_state_change_handler.h"
 #if defined(WEBOS)
 #include "wayland-text-client-protocol.h"
 #else
 #include "ozone/wayland/input/text-client-protocol.h"
 #endif
+#include "ozone/wayland/input/pointer-constraints-unstable-v1-client-protocol.h"
+#include "ozone/wayland/input/relative-pointer-unstable-v1-client-protocol.h"
+#include "ozone/wayland/input/wlr-output-power-management-unstable-v1-client-protocol.h"
 #include "ui/ozone/public/surface_factory_ozone.h"
 
+namespace base {
+class MessageLoopProxy;
+}
+
 namespace ozonewayland {
 
 class WaylandDisplayPollThread;
@@ -32,12 +44,15 @@ class WaylandShell;
 class WaylandWindow;
 struct wl_egl_window;
 
-typedef std::map<unsigned, WaylandWindow*> WindowMap;
+// Most processes have only a handful of windows, which SmallMap keeps in an
+// inline array before switching to a hash map.
+typedef base::SmallMap<base::hash_map<unsigned, WaylandWindow*> > WindowMap;
 
 // WaylandDisplay is a wrapper around wl_display. Once we get a valid
 // wl_display, the Wayland server will send different events to register
 // the Wayland compositor, shell, screens, input devices, ...
 class WaylandDisplay : public ui::WindowStateChangeHandler,
+                       public ui::IMEStateChangeHandler,
                        public ui::SurfaceFactoryOzone {
  public:
   WaylandDisplay();
@@ -51,11 +66,37 @@ class WaylandDisplay : public ui::WindowStateChangeHandler,
 
   wl_registry* registry() const { return registry_; }
 
-  WaylandInputDevice* PrimaryInput() const { return primary_input_; }
+  // Returns the seat which delivered the latest input event, or the first
+  // seat until one did. Requests answering user input, such as popup grabs,
+  // go through it.
+  WaylandInputDevice* ActiveInput() const;
+  // Called on the thread dispatching Wayland events.
+  void SetActiveInput(WaylandInputDevice* input);
+  const std::list<WaylandInputDevice*>& GetInputList() const {
+    return input_list_;
+  }
+  // Makes |input| handle input method requests. Called on the thread
+  // dispatching Wayland events when the keyboard of |input| gets focus.
+  void SetImeInput(WaylandInputDevice* input);
 
   // Returns a list of the registered screens.
   const std::list<WaylandScreen*>& GetScreenList() const;
   WaylandScreen* PrimaryScreen() const { return primary_screen_ ; }
+  // Returns the screen wrapping |output|, or NULL if there is none.
+  WaylandScreen* GetScreen(wl_output* output) const;
+
+  // Blanking notifications, called on the thread dispatching Wayland events.
+  // Windows are created and destroyed on the GPU thread, so their blanking
+  // state is updated there.
+  // Called when |screen| is powered on or off, so that the windows it shows
+  // stop or resume drawing.
+  void OnOutputPowerChanged(WaylandScreen* screen, bool powered_on);
+  // Called when the surface of window |w| enters or leaves |output|.
+  void OnWindowOutputChanged(unsigned w, wl_output* output, bool entered);
+  // Called when the shell takes window |w| off screen or shows it again.
+  void OnWindowShellHidden(unsigned w, bool hidden);
+  // Called when a size suggested for window |w| is held back.
+  void OnWindowConfigureDeferred(unsigned w);
 
   WaylandShell* GetShell() const { return shell_; }
 
@@ -66,14 +107,28 @@ class WaylandDisplay : public ui::WindowStateChangeHandler,
 #else
   struct wl_text_input_manager* GetTextInputManager() const;
 #endif
+  // Optional protocols for Pointer Lock, NULL if the compositor lacks them.
+  zwp_relative_pointer_manager_v1* GetRelativePointerManager() const {
+    return relative_pointer_manager_;
+  }
+  zwp_pointer_constraints_v1* GetPointerConstraints() const {
+    return pointer_constraints_;
+  }
 
   int GetDisplayFd() const { return wl_display_get_fd(display_); }
+  // Returns the thread dispatching Wayland events, NULL until the display is
+  // initialized.
+  WaylandDisplayPollThread* GetPollThread() const {
+    return display_poll_thread_;
+  }
   unsigned GetSerial() const { return serial_; }
   void SetSerial(unsigned serial) { serial_ = serial; }
   // Returns WaylandWindow associated with w. The ownership is not transferred
   // to the caller.
   WaylandWindow* GetWindow(unsigned window_handle) const;
-  gfx::AcceleratedWidget GetNativeWindow(unsigned window_handle);
+  // Realizes |window| and returns the EGL native window backing it. Starts
+  // processing Wayland events if needed.
+  gfx::AcceleratedWidget GetNativeWindow(WaylandWindow* window);
 
   // Destroys WaylandWindow whose handle is w.
   void DestroyWindow(unsigned w);
@@ -90,6 +145,10 @@ class WaylandDisplay : public ui::WindowStateChangeHandler,
   // Ownership is passed to the caller.
   virtual scoped_ptr<ui::SurfaceOzoneEGL> CreateEGLSurfaceForWidget(
         gfx::AcceleratedWidget widget) OVERRIDE;
+  // Software rendering into wl_shm buffers. Needs a connection to the
+  // compositor in the calling process.
+  virtual scoped_ptr<ui::SurfaceOzoneCanvas> CreateCanvasForWidget(
+        gfx::AcceleratedWidget widget) OVERRIDE;
 
   virtual bool LoadEGLGLES2Bindings(
     ui::SurfaceFactoryOzone::AddGLLibraryCallback add_gl_library,
@@ -106,12 +165,28 @@ class WaylandDisplay : public ui::WindowStateChangeHandler,
   virtual void SetWidgetTitle(unsigned w,
                               const base::string16& title) OVERRIDE;
   virtual void SetWidgetCursor(int cursor_type) OVERRIDE;
+  virtual void SetWidgetImageCursor(uint32 hash,
+                                    const SkBitmap& bitmap,
+                                    const gfx::Point& hotspot) OVERRIDE;
+  virtual void SetWidgetCachedImageCursor(uint32 hash,
+                                          const gfx::Size& size,
+                                          const gfx::Point& hotspot) OVERRIDE;
+  virtual void SetWidgetOpaque(unsigned widget, bool opaque) OVERRIDE;
+  virtual void SetWidgetPointerConstraint(
+      unsigned widget, ui::PointerConstraint constraint) OVERRIDE;
   virtual void SetWidgetAttributes(unsigned widget,
                                    unsigned parent,
                                    unsigned x,
                                    unsigned y,
                                    ui::WidgetType type) OVERRIDE;
 
+  // IMEStateChangeHandler implementation, forwarded to the seat whose
+  // keyboard has focus:
+  virtual void ResetIme() OVERRIDE;
+  virtual void ImeCaretBoundsChanged(gfx::Rect rect) OVERRIDE;
+  virtual void ShowInputPanel() OVERRIDE;
+  virtual void HideInputPanel() OVERRIDE;
+
   void LookAheadOutputGeometry();
 
  private:
@@ -133,6 +208,15 @@ class WaylandDisplay : public ui::WindowStateChangeHandler,
 
   void Terminate();
   WaylandWindow* GetWidget(unsigned w) const;
+
+  // Runs |task| on the GPU thread.
+  void PostTaskOnGpuThread(const base::Closure& task);
+  // Blanking updates, run on the GPU thread.
+  void SetOutputPowered(WaylandScreen* screen, bool powered_on);
+  void SetWindowOnScreen(unsigned w, WaylandScreen* screen, bool entered);
+  void SetWindowShellHidden(unsigned w, bool hidden);
+  void FlushWindowConfigure(unsigned w);
+
   // This handler resolves all server events used in initialization. It also
   // handles input device registration, screen registration.
   static void DisplayHandleGlobal(
@@ -161,10 +245,22 @@ class WaylandDisplay : public ui::WindowStateChangeHandler,
 #else
   struct wl_text_input_manager* text_input_manager_;
 #endif
+  zwp_relative_pointer_manager_v1* relative_pointer_manager_;
+  zwp_pointer_constraints_v1* pointer_constraints_;
+  zwlr_output_power_manager_v1* output_power_manager_;
   WaylandScreen* primary_screen_;
   WaylandScreen* look_ahead_screen_;
-  WaylandInputDevice* primary_input_;
+  // Protects |active_input_|, which changes on the poll thread while requests
+  // answering user input are made on the GPU thread.
+  mutable base::Lock active_input_lock_;
+  WaylandInputDevice* active_input_;
+  // Protects |ime_input_|, which changes on the poll thread while input
+  // method requests come in on the GPU thread.
+  base::Lock ime_lock_;
+  WaylandInputDevice* ime_input_;
   WaylandDisplayPollThread* display_poll_thread_;
+  // The GPU thread, which the display was initialized on.
+  scoped_refptr<base::MessageLoopProxy> gpu_loop_;
 
   std::list<WaylandScreen*> screen_list_;
   std::list<WaylandInputDevice*> input_list_;
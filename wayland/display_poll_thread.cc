@@ -60,13 +60,53 @@ WaylandDisplayPollThread::WaylandDisplayPollThread(wl_display* display)
     : base::Thread("WaylandDisplayPollThread"),
       display_(display),
       polling_(true, false),
-      stop_polling_(true, false) {
+      stop_polling_(true, false),
+      epoll_fd_(osEpollCreateCloExec()) {
   DCHECK(display_);
+  if (epoll_fd_ < 0)
+    LOG(ERROR) << "Epoll creation failed.";
 }
 
 WaylandDisplayPollThread::~WaylandDisplayPollThread() {
   DCHECK(!polling_.IsSignaled());
   Stop();
+  if (epoll_fd_ >= 0)
+    close(epoll_fd_);
+}
+
+bool WaylandDisplayPollThread::WatchFileDescriptor(int fd, Watcher* watcher) {
+  DCHECK(watcher);
+  base::AutoLock auto_lock(watchers_lock_);
+  struct epoll_event ep;
+  ep.events = EPOLLIN;
+  ep.data.ptr = watcher;
+  if (epoll_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ep) < 0) {
+    LOG(ERROR) << "epoll_ctl Add failed";
+    return false;
+  }
+
+  watchers_[fd] = watcher;
+  return true;
+}
+
+void WaylandDisplayPollThread::StopWatchingFileDescriptor(int fd) {
+  // Waits for a notification in progress, which may be for this watcher.
+  base::AutoLock auto_lock(watchers_lock_);
+  if (epoll_fd_ >= 0)
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, NULL);
+  watchers_.erase(fd);
+}
+
+void WaylandDisplayPollThread::NotifyWatcher(Watcher* watcher) {
+  base::AutoLock auto_lock(watchers_lock_);
+  // epoll_wait() may have returned before the watcher stopped watching.
+  for (std::map<int, Watcher*>::const_iterator i = watchers_.begin();
+       i != watchers_.end(); ++i) {
+    if (i->second == watcher) {
+      watcher->OnFileCanReadWithoutBlocking();
+      return;
+    }
+  }
 }
 
 void WaylandDisplayPollThread::StartProcessingEvents() {
@@ -86,20 +126,21 @@ void WaylandDisplayPollThread::StopProcessingEvents() {
 
 void  WaylandDisplayPollThread::DisplayRun(WaylandDisplayPollThread* data) {
   struct epoll_event ep[MAX_EVENTS];
+  // The display is registered with a NULL data pointer, watchers with their
+  // own.
+  struct epoll_event display_ep;
   int i, ret, count = 0;
   uint32_t event = 0;
   bool epoll_err = false;
+  bool display_readable = false;
   unsigned display_fd = wl_display_get_fd(data->display_);
-  int epoll_fd = osEpollCreateCloExec();
-  if (epoll_fd < 0) {
-    LOG(ERROR) << "Epoll creation failed.";
+  int epoll_fd = data->epoll_fd_;
+  if (epoll_fd < 0)
     return;
-  }
 
-  ep[0].events = EPOLLIN;
-  ep[0].data.ptr = 0;
-  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, display_fd, &ep[0]) < 0) {
-    close(epoll_fd);
+  display_ep.events = EPOLLIN;
+  display_ep.data.ptr = 0;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, display_fd, &display_ep) < 0) {
     LOG(ERROR) << "epoll_ctl Add failed";
     return;
   }
@@ -114,8 +155,8 @@ void  WaylandDisplayPollThread::DisplayRun(WaylandDisplayPollThread* data) {
     wl_display_dispatch_pending(data->display_);
     ret = wl_display_flush(data->display_);
     if (ret < 0 && errno == EAGAIN) {
-      ep[0].events = EPOLLIN | EPOLLERR | EPOLLHUP;
-      epoll_ctl(epoll_fd, EPOLL_CTL_MOD, display_fd, &ep[0]);
+      display_ep.events = EPOLLIN | EPOLLERR | EPOLLHUP;
+      epoll_ctl(epoll_fd, EPOLL_CTL_MOD, display_fd, &display_ep);
     } else if (ret < 0) {
       epoll_err = true;
       break;
@@ -134,8 +175,17 @@ void  WaylandDisplayPollThread::DisplayRun(WaylandDisplayPollThread* data) {
       break;
     }
 
+    // Run the watchers before dispatching Wayland events, which may destroy
+    // them.
+    display_readable = false;
     for (i = 0; i < count; i++) {
       event = ep[i].events;
+      if (ep[i].data.ptr) {
+        if (event & EPOLLIN)
+          data->NotifyWatcher(static_cast<Watcher*>(ep[i].data.ptr));
+        continue;
+      }
+
       // We can have cases where EPOLLIN and EPOLLHUP are both set for
       // example. Don't break if both flags are set.
       if ((event & EPOLLERR || event & EPOLLHUP) &&
@@ -144,13 +194,14 @@ void  WaylandDisplayPollThread::DisplayRun(WaylandDisplayPollThread* data) {
         break;
       }
 
-      if (event & EPOLLIN) {
-        ret = wl_display_dispatch(data->display_);
-        if (ret == -1) {
-          LOG(ERROR) << "wl_display_dispatch failed with an error." << errno;
-          epoll_err = true;
-          break;
-        }
+      display_readable = (event & EPOLLIN) != 0;
+    }
+
+    if (!epoll_err && display_readable) {
+      ret = wl_display_dispatch(data->display_);
+      if (ret == -1) {
+        LOG(ERROR) << "wl_display_dispatch failed with an error." << errno;
+        epoll_err = true;
       }
     }
 
@@ -158,7 +209,8 @@ void  WaylandDisplayPollThread::DisplayRun(WaylandDisplayPollThread* data) {
       break;
   }
 
-  close(epoll_fd);
+  // The epoll set outlives polling, keep the watchers but not the display.
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, display_fd, NULL);
   data->polling_.Reset();
   data->stop_polling_.Reset();
 }
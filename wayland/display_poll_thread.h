@@ -5,6 +5,9 @@
 #ifndef OZONE_WAYLAND_DISPLAY_POLL_THREAD_H_
 #define OZONE_WAYLAND_DISPLAY_POLL_THREAD_H_
 
+#include <map>
+
+#include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/thread.h"
 
@@ -16,9 +19,27 @@ namespace ozonewayland {
 // destroyed.
 class WaylandDisplayPollThread : public base::Thread {
  public:
+  // Gets notified on the poll thread when a watched file descriptor becomes
+  // readable. Used for timers that need to run alongside Wayland events.
+  class Watcher {
+   public:
+    virtual void OnFileCanReadWithoutBlocking() = 0;
+
+   protected:
+    virtual ~Watcher() {}
+  };
+
   explicit WaylandDisplayPollThread(wl_display* display);
   virtual ~WaylandDisplayPollThread();
 
+  // Adds |fd| to the descriptors polled together with the display. Can be
+  // called from any thread, whether or not polling has started. |watcher|
+  // must outlive the watch. Once StopWatchingFileDescriptor() returns, the
+  // watcher isn't notified anymore, so it can then be destroyed on any
+  // thread. Watchers must not call either from their notification.
+  bool WatchFileDescriptor(int fd, Watcher* watcher);
+  void StopWatchingFileDescriptor(int fd);
+
   // Starts polling on wl_display fd and read/flush requests coming from Wayland
   // compositor.
   void StartProcessingEvents();
@@ -26,9 +47,15 @@ class WaylandDisplayPollThread : public base::Thread {
   void StopProcessingEvents();
  private:
   static void DisplayRun(WaylandDisplayPollThread* data);
+  // Notifies |watcher| unless it stopped watching since epoll reported it.
+  void NotifyWatcher(Watcher* watcher);
   base::WaitableEvent polling_;  // Is set as long as the thread is polling.
   base::WaitableEvent stop_polling_;
   wl_display* display_;
+  int epoll_fd_;
+  // Held while a watcher is notified, and protects |watchers_|.
+  base::Lock watchers_lock_;
+  std::map<int, Watcher*> watchers_;
   DISALLOW_COPY_AND_ASSIGN(WaylandDisplayPollThread);
 };
 
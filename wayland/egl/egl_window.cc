@@ -19,7 +19,8 @@ EGLWindow::~EGLWindow() {
 }
 
 bool EGLWindow::Resize(int32_t width, int32_t height) {
-  // TODO(kalyan): Check if we need to sync display here.
+  // Only records the new size, buffers are reallocated by the driver when the
+  // next frame is drawn.
   wl_egl_window_resize(window_, width, height, 0, 0);
   return true;
 }
@@ -0,0 +1,113 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ozone/wayland/egl/frame_throttle.h"
+
+#include <algorithm>
+
+#include "base/debug/trace_event.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/synchronization/lock.h"
+
+namespace ozonewayland {
+
+namespace {
+
+// Compositors stop sending frame callbacks for surfaces which are not visible.
+// Don't hold frames back longer than this waiting for one.
+const int kFrameTimeoutMs = 100;
+
+base::LazyInstance<base::Lock>::Leaky g_throttle_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+WaylandFrameThrottle::WaylandFrameThrottle(struct wl_surface* surface,
+                                           size_t max_pending_frames,
+                                           const base::Closure& frame_ready)
+    : surface_(surface),
+      max_pending_frames_(max_pending_frames),
+      frame_ready_(frame_ready),
+      frame_ready_loop_(base::MessageLoopProxy::current()),
+      frame_held_(false) {
+  DCHECK(surface_);
+  DCHECK_GT(max_pending_frames_, 0u);
+}
+
+WaylandFrameThrottle::~WaylandFrameThrottle() {
+  // Clearing the user data under the lock tells FrameDone(), should the poll
+  // thread be dispatching one of the callbacks, that it is destroyed already.
+  base::AutoLock auto_lock(g_throttle_lock.Get());
+  for (std::list<struct wl_callback*>::iterator it =
+           pending_callbacks_.begin();
+       it != pending_callbacks_.end(); ++it) {
+    wl_callback_set_user_data(*it, NULL);
+    wl_callback_destroy(*it);
+  }
+  pending_callbacks_.clear();
+}
+
+bool WaylandFrameThrottle::RequestFrame() {
+  base::AutoLock auto_lock(g_throttle_lock.Get());
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (pending_callbacks_.empty())
+    last_frame_done_ = now;
+
+  if (pending_callbacks_.size() >= max_pending_frames_) {
+    if (now - last_frame_done_ <
+        base::TimeDelta::FromMilliseconds(kFrameTimeoutMs)) {
+      TRACE_EVENT_INSTANT0("wayland", "WaylandFrameThrottle::HoldFrame",
+                           TRACE_EVENT_SCOPE_THREAD);
+      frame_held_ = true;
+      return false;
+    }
+
+    // The callbacks already pending tell when the surface is presented again.
+    DVLOG(1) << "Timed out waiting for a frame callback";
+    frame_held_ = false;
+    return true;
+  }
+
+  static const struct wl_callback_listener kFrameListener = {
+    WaylandFrameThrottle::FrameDone
+  };
+
+  struct wl_callback* callback = wl_surface_frame(surface_);
+  wl_callback_add_listener(callback, &kFrameListener, this);
+  pending_callbacks_.push_back(callback);
+  frame_held_ = false;
+  return true;
+}
+
+// static
+void WaylandFrameThrottle::FrameDone(void* data,
+                                     struct wl_callback* callback,
+                                     uint32_t time) {
+  base::AutoLock auto_lock(g_throttle_lock.Get());
+  // |data| was read before taking the lock, the throttle may have destroyed
+  // the callback since.
+  WaylandFrameThrottle* throttle =
+      static_cast<WaylandFrameThrottle*>(wl_callback_get_user_data(callback));
+  if (!throttle)
+    return;
+
+  wl_callback_destroy(callback);
+  std::list<struct wl_callback*>::iterator it =
+      std::find(throttle->pending_callbacks_.begin(),
+                throttle->pending_callbacks_.end(),
+                callback);
+  if (it != throttle->pending_callbacks_.end())
+    throttle->pending_callbacks_.erase(it);
+
+  throttle->last_frame_done_ = base::TimeTicks::Now();
+  if (throttle->frame_held_) {
+    throttle->frame_held_ = false;
+    throttle->frame_ready_loop_->PostTask(FROM_HERE, throttle->frame_ready_);
+  }
+}
+
+}  // namespace ozonewayland
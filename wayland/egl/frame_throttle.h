@@ -0,0 +1,69 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OZONE_WAYLAND_EGL_FRAME_THROTTLE_H_
+#define OZONE_WAYLAND_EGL_FRAME_THROTTLE_H_
+
+#include <wayland-client.h>
+
+#include <list>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+
+namespace base {
+class MessageLoopProxy;
+}
+
+namespace ozonewayland {
+
+// Limits the number of frames queued on the compositor for a surface swapped
+// with a swap interval of 0, using wl_surface frame callbacks. The callbacks
+// are dispatched on the display poll thread. The thread submitting frames never
+// waits: it is told to hold a frame back while the compositor is
+// |max_pending_frames| frames behind, and |frame_ready| is posted to it once
+// the compositor caught up.
+class WaylandFrameThrottle {
+ public:
+  // Must be created on the thread submitting the frames.
+  WaylandFrameThrottle(struct wl_surface* surface,
+                       size_t max_pending_frames,
+                       const base::Closure& frame_ready);
+  ~WaylandFrameThrottle();
+
+  // Called before a frame is swapped. Returns false if too many frames are
+  // pending, the frame should then be held back until |frame_ready| runs.
+  // Otherwise asks to be notified once the frame is presented, the request
+  // applies to the commit done by the swap. Frames are let through once no
+  // frame callback arrived for a while, most likely because the surface is
+  // hidden, until one arrives again.
+  bool RequestFrame();
+
+ private:
+  static void FrameDone(void* data,
+                        struct wl_callback* callback,
+                        uint32_t time);
+
+  struct wl_surface* surface_;
+  const size_t max_pending_frames_;
+  const base::Closure frame_ready_;
+  scoped_refptr<base::MessageLoopProxy> frame_ready_loop_;
+
+  // The members below are protected by the lock shared by all throttles,
+  // which also protects the user data of the callbacks.
+  std::list<struct wl_callback*> pending_callbacks_;
+  // Time of the last frame callback, or of the first frame requested since
+  // none was pending.
+  base::TimeTicks last_frame_done_;
+  // Set while a frame is held back.
+  bool frame_held_;
+
+  DISALLOW_COPY_AND_ASSIGN(WaylandFrameThrottle);
+};
+
+}  // namespace ozonewayland
+
+#endif  // OZONE_WAYLAND_EGL_FRAME_THROTTLE_H_
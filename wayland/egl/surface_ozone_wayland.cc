@@ -4,39 +4,315 @@
 
 #include "ozone/wayland/egl/surface_ozone_wayland.h"
 
+#include <EGL/egl.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base/bind.h"
 #include "ozone/ui/gfx/vsync_provider_wayland.h"
 #include "ozone/wayland/display.h"
+#include "ozone/wayland/egl/frame_throttle.h"
+#include "ozone/wayland/shell/shell_surface.h"
 #include "ozone/wayland/window.h"
 
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 namespace ozonewayland {
 
-SurfaceOzoneWayland::SurfaceOzoneWayland(unsigned handle)
-    : handle_(handle) {
+namespace {
+
+// Number of frames of damage kept for buffer age queries. Drivers rarely
+// cycle through more than three or four buffers.
+const size_t kMaxDamageHistory = 4;
+
+typedef EGLBoolean (*SwapBuffersWithDamageProc)(EGLDisplay display,
+                                                EGLSurface surface,
+                                                EGLint* rects,
+                                                EGLint n_rects);
+
+bool HasExtension(const char* extensions, const char* name) {
+  size_t length = strlen(name);
+  for (const char* p = extensions; (p = strstr(p, name)); p += length) {
+    if ((p == extensions || p[-1] == ' ') &&
+        (p[length] == ' ' || p[length] == '\0')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the swap with damage entry point of |display|, or NULL if it is not
+// supported. All windows share the same EGL display, so the lookup is done
+// once.
+SwapBuffersWithDamageProc GetSwapBuffersWithDamageProc(EGLDisplay display) {
+  static bool initialized = false;
+  static SwapBuffersWithDamageProc proc = NULL;
+  if (initialized)
+    return proc;
+
+  initialized = true;
+  const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (!extensions)
+    return NULL;
+
+  if (HasExtension(extensions, "EGL_EXT_swap_buffers_with_damage")) {
+    proc = reinterpret_cast<SwapBuffersWithDamageProc>(
+        eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+  } else if (HasExtension(extensions, "EGL_KHR_swap_buffers_with_damage")) {
+    proc = reinterpret_cast<SwapBuffersWithDamageProc>(
+        eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+  }
+
+  DVLOG_IF(1, !proc) << "Swap buffers with damage is not supported";
+  return proc;
+}
+
+bool SupportsBufferAge(EGLDisplay display) {
+  static bool initialized = false;
+  static bool supported = false;
+  if (initialized)
+    return supported;
+
+  initialized = true;
+  const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  supported = extensions && HasExtension(extensions, "EGL_EXT_buffer_age");
+  DVLOG_IF(1, !supported) << "EGL_EXT_buffer_age is not supported";
+  return supported;
+}
+
+// Returns the number of frames a surface may have queued on the compositor
+// when swapping without waiting for vblank, or 0 to keep the default, blocking
+// swap interval of 1. OZONE_WAYLAND_NONBLOCKING_SWAP enables non-blocking swaps
+// with double buffering, OZONE_WAYLAND_TRIPLE_BUFFER with one more frame in
+// flight.
+size_t GetMaxPendingFrames() {
+  static size_t max_pending_frames = 0;
+  static bool initialized = false;
+  if (initialized)
+    return max_pending_frames;
+
+  initialized = true;
+  if (getenv("OZONE_WAYLAND_TRIPLE_BUFFER"))
+    max_pending_frames = 3;
+  else if (getenv("OZONE_WAYLAND_NONBLOCKING_SWAP"))
+    max_pending_frames = 2;
+
+  return max_pending_frames;
+}
+
+}  // namespace
+
+SurfaceOzoneWayland::SurfaceOzoneWayland(WaylandWindow* window)
+    : window_(window),
+      swap_interval_set_(false),
+      egl_display_(EGL_NO_DISPLAY),
+      egl_surface_(EGL_NO_SURFACE),
+      egl_context_(EGL_NO_CONTEXT),
+      frame_held_(false),
+      weak_ptr_factory_(this) {
+  DCHECK(window_);
 }
 
 SurfaceOzoneWayland::~SurfaceOzoneWayland() {
-  WaylandDisplay::GetInstance()->DestroyWindow(handle_);
+  // Pending frame callbacks belong to the surface of the window.
+  frame_throttle_.reset();
+  WaylandDisplay::GetInstance()->DestroyWindow(window_->Handle());
   WaylandDisplay::GetInstance()->FlushDisplay();
 }
 
 intptr_t SurfaceOzoneWayland::GetNativeWindow() {
-  return WaylandDisplay::GetInstance()->GetNativeWindow(handle_);
+  intptr_t native_window =
+      WaylandDisplay::GetInstance()->GetNativeWindow(window_);
+
+  size_t max_pending_frames = GetMaxPendingFrames();
+  if (max_pending_frames && !frame_throttle_) {
+    frame_throttle_.reset(new WaylandFrameThrottle(
+        window_->ShellSurface()->GetWLSurface(),
+        max_pending_frames,
+        base::Bind(&SurfaceOzoneWayland::SwapHeldFrame,
+                   weak_ptr_factory_.GetWeakPtr())));
+  }
+
+  return native_window;
 }
 
 bool SurfaceOzoneWayland::ResizeNativeWindow(
     const gfx::Size& viewport_size) {
-  WaylandWindow* window = WaylandDisplay::GetInstance()->GetWindow(handle_);
-  DCHECK(window);
-  window->Resize(viewport_size.width(), viewport_size.height());
+  window_->Resize(viewport_size.width(), viewport_size.height());
+  // Buffers are reallocated on resize, their old contents are of no use.
+  damage_history_.clear();
+  // A frame of the old size is of no use either.
+  frame_held_ = false;
+  held_damage_ = gfx::Rect();
   return true;
 }
 
+bool SurfaceOzoneWayland::OnBeforeSwapBuffers() {
+  held_damage_ = gfx::Rect(window_->GetBounds().size());
+  return ThrottleFrame();
+}
+
 bool SurfaceOzoneWayland::OnSwapBuffers() {
+  held_damage_ = gfx::Rect();
+  AddDamage(gfx::Rect(window_->GetBounds().size()));
+  return OnFrameSwapped();
+}
+
+bool SurfaceOzoneWayland::ThrottleFrame() {
+  if (!frame_throttle_)
+    return true;
+
+  egl_display_ = eglGetCurrentDisplay();
+  egl_surface_ = eglGetCurrentSurface(EGL_DRAW);
+  egl_context_ = eglGetCurrentContext();
+
+  // With a swap interval of 0 eglSwapBuffers no longer waits for the frame
+  // callback of the previous swap, and |frame_throttle_| paces the frames.
+  if (!swap_interval_set_) {
+    swap_interval_set_ = true;
+    if (!eglSwapInterval(egl_display_, 0))
+      LOG(WARNING) << "Failed to disable blocking swaps";
+  }
+
+  frame_held_ = !frame_throttle_->RequestFrame();
+  return !frame_held_;
+}
+
+bool SurfaceOzoneWayland::SupportsSwapBuffersWithDamage() {
+  EGLDisplay egl_display = eglGetCurrentDisplay();
+  EGLSurface egl_surface = eglGetCurrentSurface(EGL_DRAW);
+  if (egl_surface == EGL_NO_SURFACE ||
+      !GetSwapBuffersWithDamageProc(egl_display)) {
+    return false;
+  }
+
+  // Chromium only redraws the damaged area of a partial swap, the rest of the
+  // back buffer has to hold the previous frame.
+  if (!eglSurfaceAttrib(egl_display, egl_surface, EGL_SWAP_BEHAVIOR,
+                        EGL_BUFFER_PRESERVED)) {
+    DVLOG(1) << "Preserved swaps are not supported";
+    return false;
+  }
+
   return true;
 }
 
+bool SurfaceOzoneWayland::SwapBuffersWithDamage(const gfx::Rect& damage) {
+  // A held back frame stays in the back buffer, the next frame is drawn on top
+  // of it and has to report its damage too.
+  held_damage_.Union(
+      gfx::IntersectRects(damage, gfx::Rect(window_->GetBounds().size())));
+  if (!ThrottleFrame())
+    return true;
+
+  gfx::Rect frame_damage = held_damage_;
+  held_damage_ = gfx::Rect();
+  return SwapFrameWithDamage(eglGetCurrentDisplay(),
+                             eglGetCurrentSurface(EGL_DRAW),
+                             frame_damage);
+}
+
+bool SurfaceOzoneWayland::SwapFrameWithDamage(EGLDisplay egl_display,
+                                              EGLSurface egl_surface,
+                                              const gfx::Rect& damage) {
+  SwapBuffersWithDamageProc swap_with_damage =
+      GetSwapBuffersWithDamageProc(egl_display);
+  DCHECK(swap_with_damage);
+
+  gfx::Rect bounds(window_->GetBounds().size());
+  gfx::Rect buffer_damage = GetBufferDamage(egl_display, egl_surface, damage);
+  AddDamage(damage);
+
+  // EGL damage rectangles have their origin at the bottom left.
+  EGLint rect[4] = {
+    buffer_damage.x(),
+    bounds.height() - buffer_damage.bottom(),
+    buffer_damage.width(),
+    buffer_damage.height()
+  };
+
+  if (!swap_with_damage(egl_display, egl_surface, rect, 1))
+    return false;
+
+  return OnFrameSwapped();
+}
+
+bool SurfaceOzoneWayland::OnFrameSwapped() {
+  window_->OnFrameSwapped();
+  return true;
+}
+
+void SurfaceOzoneWayland::SwapHeldFrame() {
+  // A newer frame may have been swapped in the meantime.
+  if (!frame_held_)
+    return;
+
+  EGLDisplay current_display = eglGetCurrentDisplay();
+  EGLSurface current_draw = eglGetCurrentSurface(EGL_DRAW);
+  EGLSurface current_read = eglGetCurrentSurface(EGL_READ);
+  EGLContext current_context = eglGetCurrentContext();
+  if (!eglMakeCurrent(egl_display_, egl_surface_, egl_surface_,
+                      egl_context_)) {
+    LOG(ERROR) << "Failed to make the context of a held back frame current";
+    frame_held_ = false;
+    return;
+  }
+
+  if (frame_throttle_->RequestFrame()) {
+    frame_held_ = false;
+    gfx::Rect frame_damage = held_damage_;
+    held_damage_ = gfx::Rect();
+    if (GetSwapBuffersWithDamageProc(egl_display_)) {
+      SwapFrameWithDamage(egl_display_, egl_surface_, frame_damage);
+    } else if (eglSwapBuffers(egl_display_, egl_surface_)) {
+      AddDamage(gfx::Rect(window_->GetBounds().size()));
+      OnFrameSwapped();
+    }
+  }
+
+  if (current_context == EGL_NO_CONTEXT) {
+    eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+  } else {
+    eglMakeCurrent(current_display, current_draw, current_read,
+                   current_context);
+  }
+}
+
 scoped_ptr<gfx::VSyncProvider> SurfaceOzoneWayland::CreateVSyncProvider() {
   return scoped_ptr<gfx::VSyncProvider>(new gfx::WaylandSyncProvider());
 }
 
+void SurfaceOzoneWayland::AddDamage(const gfx::Rect& damage) {
+  damage_history_.push_front(damage);
+  if (damage_history_.size() > kMaxDamageHistory)
+    damage_history_.pop_back();
+}
+
+gfx::Rect SurfaceOzoneWayland::GetBufferDamage(EGLDisplay egl_display,
+                                               EGLSurface egl_surface,
+                                               const gfx::Rect& damage) {
+  gfx::Rect full_damage(window_->GetBounds().size());
+  if (!SupportsBufferAge(egl_display))
+    return damage;
+
+  EGLint age = 0;
+  if (!eglQuerySurface(egl_display, egl_surface, EGL_BUFFER_AGE_EXT, &age))
+    return full_damage;
+
+  // An age of 0 means the contents are undefined, an age of n means the
+  // buffer was last presented n frames ago and missed the n - 1 frames since.
+  if (age <= 0 || static_cast<size_t>(age) > damage_history_.size() + 1)
+    return full_damage;
+
+  gfx::Rect buffer_damage = damage;
+  for (EGLint i = 0; i < age - 1; ++i)
+    buffer_damage.Union(damage_history_[i]);
+
+  buffer_damage.Intersect(full_damage);
+  return buffer_damage;
+}
+
 }  // namespace ozonewayland
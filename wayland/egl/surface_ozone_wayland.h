@@ -5,17 +5,28 @@
 #ifndef OZONE_WAYLAND_EGL_SURFACE_OZONE_WAYLAND
 #define OZONE_WAYLAND_EGL_SURFACE_OZONE_WAYLAND
 
+#include <EGL/egl.h>
+
+#include <deque>
+
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "ui/gfx/gfx_export.h"
+#include "ui/gfx/rect.h"
 #include "ui/ozone/public/surface_ozone_egl.h"
 
 namespace ozonewayland {
 
+class WaylandFrameThrottle;
+class WaylandWindow;
+
 // Provides EGL support for SurfaceOzone.
 class SurfaceOzoneWayland : public ui::SurfaceOzoneEGL {
  public:
-  explicit SurfaceOzoneWayland(unsigned handle);
+  // |window| is owned by WaylandDisplay but destroyed together with this
+  // surface, so it stays valid for the lifetime of the surface.
+  explicit SurfaceOzoneWayland(WaylandWindow* window);
   virtual ~SurfaceOzoneWayland() OVERRIDE;
 
   // SurfaceOzone:
@@ -23,9 +34,60 @@ class SurfaceOzoneWayland : public ui::SurfaceOzoneEGL {
   virtual bool ResizeNativeWindow(const gfx::Size& viewport_size) OVERRIDE;
   virtual bool OnSwapBuffers() OVERRIDE;
   virtual scoped_ptr<gfx::VSyncProvider> CreateVSyncProvider() OVERRIDE;
+  virtual bool SupportsSwapBuffersWithDamage() OVERRIDE;
+  virtual bool SwapBuffersWithDamage(const gfx::Rect& damage) OVERRIDE;
+  virtual bool OnBeforeSwapBuffers() OVERRIDE;
 
  private:
-  unsigned handle_;
+  // Does what follows a swap of either kind.
+  bool OnFrameSwapped();
+
+  // Asks |frame_throttle_|, if any, whether the frame about to be swapped on
+  // the current EGL surface can be presented now. Otherwise the frame is held
+  // back and returns false.
+  bool ThrottleFrame();
+
+  // Swaps the buffers of |egl_surface| through the swap with damage entry
+  // point, telling the compositor that |damage| changed.
+  bool SwapFrameWithDamage(EGLDisplay egl_display,
+                           EGLSurface egl_surface,
+                           const gfx::Rect& damage);
+
+  // Called once |frame_throttle_| is ready for the frame held back by
+  // OnBeforeSwapBuffers(). Makes the context of the last swap current to
+  // present the frame, and restores the current context afterwards.
+  void SwapHeldFrame();
+
+  // Records |damage| as the area which changed in the frame being swapped.
+  void AddDamage(const gfx::Rect& damage);
+
+  // Returns the area of the back buffer of |egl_surface| which differs from
+  // the last frame, given that |damage| was redrawn. Uses EGL_EXT_buffer_age
+  // to add the damage of the frames the buffer missed, or returns the whole
+  // window if its age is unknown.
+  gfx::Rect GetBufferDamage(EGLDisplay egl_display,
+                            EGLSurface egl_surface,
+                            const gfx::Rect& damage);
+
+  WaylandWindow* window_;
+
+  // Set when non-blocking swaps are enabled, see GetMaxPendingFrames().
+  scoped_ptr<WaylandFrameThrottle> frame_throttle_;
+  bool swap_interval_set_;
+
+  // EGL state of the last swap, used to present a held back frame.
+  EGLDisplay egl_display_;
+  EGLSurface egl_surface_;
+  EGLContext egl_context_;
+  // Set while the frame in the back buffer is held back. |held_damage_| is
+  // the area changed since the last frame which was swapped.
+  bool frame_held_;
+  gfx::Rect held_damage_;
+
+  // Damage of the most recently swapped frames, newest first.
+  std::deque<gfx::Rect> damage_history_;
+
+  base::WeakPtrFactory<SurfaceOzoneWayland> weak_ptr_factory_;
   DISALLOW_COPY_AND_ASSIGN(SurfaceOzoneWayland);
 };
 
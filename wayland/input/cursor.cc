@@ -4,16 +4,40 @@
 
 #include "ozone/wayland/input/cursor.h"
 
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <list>
+#include <map>
 #include <vector>
 
 #include "base/logging.h"
 #include "ozone/wayland/display.h"
+#include "ozone/wayland/shm/shm_buffer_pool.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 
 namespace ozonewayland {
 // This number should be equal to size of array defined in WaylandCursorData
 // constructor.
 const unsigned TotalCursorTypes = 24;
 
+// Upper bound of the memory used by the buffers of image cursors. Web pages
+// rarely use more than a handful of them, at most 128x128 pixels each.
+const size_t kMaxImageCursorBytes = 2 * 1024 * 1024;
+
+// A ready to attach image of a cursor.
+struct WaylandCursorFrame {
+  struct wl_buffer* buffer;
+  int width;
+  int height;
+  int hotspot_x;
+  int hotspot_y;
+};
+
+// Loads the cursor theme and creates the buffers of all the frames of all the
+// supported cursors upfront, so that changing the cursor only attaches a
+// buffer.
 class WaylandCursorData {
  public:
   explicit WaylandCursorData(wl_shm* shm);
@@ -35,21 +59,68 @@ class WaylandCursorData {
     }
   }
 
-  struct wl_cursor_image* GetCursorImage(WaylandCursor::CursorType index);
+  // Returns NULL if the theme doesn't have a cursor for |type|.
+  struct wl_cursor* GetCursor(WaylandCursor::CursorType type);
+  const std::vector<WaylandCursorFrame>& GetFrames(
+      WaylandCursor::CursorType type);
+
+  // Returns the frame of the image cursor identified by |key|, or NULL if it
+  // isn't cached.
+  const WaylandCursorFrame* FindImageFrame(const WaylandImageCursorKey& key);
+  // Returns the frame of the image cursor identified by |key|, uploading
+  // |bitmap| first if it isn't cached, or NULL on failure. Evicts the least
+  // recently used images when the cache grows too large, except |in_use|.
+  // Only used from the GPU thread.
+  const WaylandCursorFrame* GetImageFrame(const WaylandImageCursorKey& key,
+                                          const SkBitmap& bitmap,
+                                          const WaylandImageCursorKey& in_use);
 
  private:
+  struct ImageEntry {
+    WaylandImageCursorKey key;
+    WaylandCursorFrame frame;
+    size_t size;
+  };
+  typedef std::list<ImageEntry> ImageList;
+
+  bool UploadImage(const SkBitmap& bitmap,
+                   const gfx::Point& hotspot,
+                   ImageEntry* entry);
+  void EvictImages(const WaylandImageCursorKey& in_use);
+
+  wl_shm* shm_;
   wl_cursor_theme* cursor_theme_;
   // All supported Cursor types.
   std::vector<wl_cursor*> cursors_;
+  // Frames of each of |cursors_|.
+  std::vector<std::vector<WaylandCursorFrame> > frames_;
+  // Image cursors, most recently used first.
+  ImageList images_;
+  std::map<WaylandImageCursorKey, ImageList::iterator> image_map_;
+  size_t images_size_;
   static WaylandCursorData* impl_;
   DISALLOW_COPY_AND_ASSIGN(WaylandCursorData);
 };
 
 WaylandCursorData* WaylandCursorData::impl_ = NULL;
 
+bool WaylandImageCursorKey::operator<(
+    const WaylandImageCursorKey& other) const {
+  if (hash != other.hash)
+    return hash < other.hash;
+  if (size.width() != other.size.width())
+    return size.width() < other.size.width();
+  if (size.height() != other.size.height())
+    return size.height() < other.size.height();
+  return hotspot < other.hotspot;
+}
+
 WaylandCursorData::WaylandCursorData(wl_shm* shm)
-    : cursor_theme_(NULL),
-      cursors_(std::vector<wl_cursor*>(TotalCursorTypes)) {
+    : shm_(shm),
+      cursor_theme_(NULL),
+      cursors_(std::vector<wl_cursor*>(TotalCursorTypes)),
+      frames_(TotalCursorTypes),
+      images_size_(0) {
   // This list should be always in sync with WaylandCursor::CursorType
   const char* cursor_names[] = {
     "default",
@@ -82,30 +153,158 @@ WaylandCursorData::WaylandCursorData(wl_shm* shm)
   cursor_theme_ = wl_cursor_theme_load(NULL, 24, shm);
   DCHECK(cursor_theme_);
 
-  for (unsigned i = 0; i < TotalCursorTypes; i++)
+  for (unsigned i = 0; i < TotalCursorTypes; i++) {
     cursors_[i] = wl_cursor_theme_get_cursor(cursor_theme_, cursor_names[i]);
+    if (!cursors_[i])
+      continue;
+
+    for (unsigned j = 0; j < cursors_[i]->image_count; j++) {
+      struct wl_cursor_image* image = cursors_[i]->images[j];
+      WaylandCursorFrame frame;
+      frame.buffer = wl_cursor_image_get_buffer(image);
+      frame.width = image->width;
+      frame.height = image->height;
+      frame.hotspot_x = image->hotspot_x;
+      frame.hotspot_y = image->hotspot_y;
+      frames_[i].push_back(frame);
+    }
+  }
 }
 
-struct wl_cursor_image* WaylandCursorData::GetCursorImage(
+struct wl_cursor* WaylandCursorData::GetCursor(
     WaylandCursor::CursorType type) {
   int index = type - 1;
-  const struct wl_cursor* cursor = cursors_.at(index);
-  if (!cursor)
+  struct wl_cursor* cursor = cursors_.at(index);
+  if (!cursor || !cursor->image_count)
+    return NULL;
+
+  return cursor;
+}
+
+const std::vector<WaylandCursorFrame>& WaylandCursorData::GetFrames(
+    WaylandCursor::CursorType type) {
+  return frames_.at(type - 1);
+}
+
+const WaylandCursorFrame* WaylandCursorData::FindImageFrame(
+    const WaylandImageCursorKey& key) {
+  std::map<WaylandImageCursorKey, ImageList::iterator>::iterator it =
+      image_map_.find(key);
+  if (it == image_map_.end())
     return NULL;
 
-  return cursor->images[0];
+  images_.splice(images_.begin(), images_, it->second);
+  return &images_.front().frame;
+}
+
+const WaylandCursorFrame* WaylandCursorData::GetImageFrame(
+    const WaylandImageCursorKey& key,
+    const SkBitmap& bitmap,
+    const WaylandImageCursorKey& in_use) {
+  const WaylandCursorFrame* frame = FindImageFrame(key);
+  if (frame)
+    return frame;
+
+  ImageEntry entry;
+  entry.key = key;
+  if (!UploadImage(bitmap, key.hotspot, &entry))
+    return NULL;
+
+  images_.push_front(entry);
+  image_map_[key] = images_.begin();
+  images_size_ += entry.size;
+  EvictImages(in_use);
+  return &images_.front().frame;
+}
+
+bool WaylandCursorData::UploadImage(const SkBitmap& bitmap,
+                                    const gfx::Point& hotspot,
+                                    ImageEntry* entry) {
+  SkBitmap image;
+  if (bitmap.colorType() == kN32_SkColorType) {
+    image = bitmap;
+  } else if (!bitmap.copyTo(&image, kN32_SkColorType)) {
+    LOG(ERROR) << "Failed to convert the cursor image";
+    return false;
+  }
+
+  int width = image.width();
+  int height = image.height();
+  int stride = width * 4;
+  size_t size = static_cast<size_t>(stride) * height;
+  if (!size)
+    return false;
+
+  int fd = CreateAnonymousFile(size);
+  if (fd < 0)
+    return false;
+
+  void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    PLOG(ERROR) << "Failed to map the cursor image";
+    close(fd);
+    return false;
+  }
+
+  // N32 is the same layout as WL_SHM_FORMAT_ARGB8888, premultiplied.
+  {
+    SkAutoLockPixels lock(image);
+    for (int y = 0; y < height; ++y) {
+      memcpy(static_cast<uint8*>(data) + y * stride,
+             image.getAddr32(0, y),
+             stride);
+    }
+  }
+
+  // The buffer keeps the memory alive on the compositor side.
+  struct wl_shm_pool* pool = wl_shm_create_pool(shm_, fd, size);
+  entry->frame.buffer = wl_shm_pool_create_buffer(pool, 0, width, height,
+                                                  stride,
+                                                  WL_SHM_FORMAT_ARGB8888);
+  wl_shm_pool_destroy(pool);
+  munmap(data, size);
+  close(fd);
+
+  entry->frame.width = width;
+  entry->frame.height = height;
+  entry->frame.hotspot_x = hotspot.x();
+  entry->frame.hotspot_y = hotspot.y();
+  entry->size = size;
+  return entry->frame.buffer != NULL;
+}
+
+void WaylandCursorData::EvictImages(const WaylandImageCursorKey& in_use) {
+  // The most recently used image is the one about to be shown, keep it.
+  ImageList::iterator it = --images_.end();
+  while (images_size_ > kMaxImageCursorBytes && it != images_.begin()) {
+    ImageList::iterator victim = it--;
+    if (victim->key == in_use)
+      continue;
+
+    wl_buffer_destroy(victim->frame.buffer);
+    images_size_ -= victim->size;
+    image_map_.erase(victim->key);
+    images_.erase(victim);
+  }
 }
 
 WaylandCursorData::~WaylandCursorData() {
+  for (ImageList::iterator it = images_.begin(); it != images_.end(); ++it)
+    wl_buffer_destroy(it->frame.buffer);
   wl_cursor_theme_destroy(cursor_theme_);
 
+  // The buffers belong to the theme.
+  frames_.clear();
   if (!cursors_.empty())
     cursors_.clear();
 }
 
 WaylandCursor::WaylandCursor(wl_shm* shm) : input_pointer_(NULL),
     pointer_surface_(NULL),
-    current_cursor_(CURSOR_UNSET) {
+    current_cursor_(CURSOR_UNSET),
+    shown_cursor_(CURSOR_UNSET),
+    current_serial_(0),
+    current_frame_(0) {
   WaylandCursorData::InitializeCursorData(shm);
   WaylandDisplay* display = WaylandDisplay::GetInstance();
   pointer_surface_ = wl_compositor_create_surface(display->GetCompositor());
@@ -125,39 +324,146 @@ void WaylandCursor::Update(CursorType type, uint32_t serial) {
     return;
 
   DCHECK(type != CURSOR_UNSET);
-  CursorType cursor_type = type;
-  wl_cursor_image* image = WaylandCursorData::GetInstance()->GetCursorImage(
-      cursor_type);
+  // Hovering over content asks for the same cursor on every mouse move.
+  if (type == current_cursor_ && serial == current_serial_)
+    return;
 
-  if (!image) {
+  WaylandCursorData* data = WaylandCursorData::GetInstance();
+  CursorType cursor_type = type;
+  if (!data->GetCursor(cursor_type)) {
     LOG(INFO) << "The current cursor theme does not have a cursor for type "
               << cursor_type << ". Falling back to the default cursor.";
-    // The cursor currently being displayed is already the default one, so we
-    // can just continue showing it.
-    if (current_cursor_ == CURSOR_LEFT_PTR)
-      return;
-
     cursor_type = CURSOR_LEFT_PTR;
-    image = WaylandCursorData::GetInstance()->GetCursorImage(cursor_type);
-    DCHECK(image);
+    DCHECK(data->GetCursor(cursor_type));
   }
 
-  current_cursor_ = cursor_type;
-  struct wl_buffer* buffer = wl_cursor_image_get_buffer(image);
-  int width = image->width;
-  int height = image->height;
+  current_cursor_ = type;
+  current_image_ = WaylandImageCursorKey();
+  current_serial_ = serial;
+  // The cursor currently being displayed may already be the right one, only
+  // the pointer focus changed.
+  bool same_image = cursor_type == shown_cursor_;
+  shown_cursor_ = cursor_type;
+
+  const std::vector<WaylandCursorFrame>& frames =
+      data->GetFrames(cursor_type);
+  if (!same_image) {
+    CancelAnimation();
+    current_frame_ = 0;
+  }
+
+  const WaylandCursorFrame& frame = frames[current_frame_];
+  wl_pointer_set_cursor(input_pointer_,
+                        serial,
+                        pointer_surface_,
+                        frame.hotspot_x,
+                        frame.hotspot_y);
+  if (same_image)
+    return;
+
+  CommitFrame(&frame);
+  if (frames.size() > 1)
+    StartAnimation();
+}
+
+void WaylandCursor::UpdateBitmap(uint32 hash,
+                                 const SkBitmap& bitmap,
+                                 const gfx::Point& hotspot,
+                                 uint32_t serial) {
+  if (!input_pointer_)
+    return;
+
+  WaylandImageCursorKey key(hash,
+                            gfx::Size(bitmap.width(), bitmap.height()),
+                            hotspot);
+  const WaylandCursorFrame* frame =
+      WaylandCursorData::GetInstance()->GetImageFrame(
+          key, bitmap, current_image_);
+  if (frame)
+    ShowImage(key, frame, serial);
+}
+
+bool WaylandCursor::UpdateCachedBitmap(uint32 hash,
+                                       const gfx::Size& size,
+                                       const gfx::Point& hotspot,
+                                       uint32_t serial) {
+  if (!input_pointer_)
+    return true;
+
+  WaylandImageCursorKey key(hash, size, hotspot);
+  const WaylandCursorFrame* frame =
+      WaylandCursorData::GetInstance()->FindImageFrame(key);
+  if (!frame)
+    return false;
+
+  ShowImage(key, frame, serial);
+  return true;
+}
+
+void WaylandCursor::ShowImage(const WaylandImageCursorKey& key,
+                              const WaylandCursorFrame* frame,
+                              uint32_t serial) {
+  bool same_image = current_cursor_ == CURSOR_UNSET && current_image_.hash &&
+      key == current_image_;
+  if (same_image && serial == current_serial_)
+    return;
+
+  CancelAnimation();
+  current_cursor_ = CURSOR_UNSET;
+  shown_cursor_ = CURSOR_UNSET;
+  current_image_ = key;
+  current_serial_ = serial;
   wl_pointer_set_cursor(input_pointer_,
                         serial,
                         pointer_surface_,
-                        image->hotspot_x,
-                        image->hotspot_y);
+                        frame->hotspot_x,
+                        frame->hotspot_y);
+  if (!same_image)
+    CommitFrame(frame);
+}
 
+void WaylandCursor::CommitFrame(const WaylandCursorFrame* frame) {
   struct wl_surface* surface = pointer_surface_;
-  wl_surface_attach(surface, buffer, 0, 0);
-  wl_surface_damage(surface, 0, 0, width, height);
+  wl_surface_attach(surface, frame->buffer, 0, 0);
+  wl_surface_damage(surface, 0, 0, frame->width, frame->height);
   wl_surface_commit(surface);
 }
 
+void WaylandCursor::StartAnimation() {
+  animation_start_ = base::TimeTicks::Now();
+  OnAnimationTimer();
+}
+
+void WaylandCursor::CancelAnimation() {
+  animation_timer_.Stop();
+}
+
+void WaylandCursor::OnAnimationTimer() {
+  WaylandCursorData* cursor_data = WaylandCursorData::GetInstance();
+  struct wl_cursor* theme_cursor = cursor_data->GetCursor(shown_cursor_);
+  uint32_t elapsed =
+      (base::TimeTicks::Now() - animation_start_).InMilliseconds();
+  uint32_t duration = 0;
+  size_t index =
+      wl_cursor_frame_and_duration(theme_cursor, elapsed, &duration);
+  if (index != current_frame_) {
+    current_frame_ = index;
+    const std::vector<WaylandCursorFrame>& frames =
+        cursor_data->GetFrames(shown_cursor_);
+    CommitFrame(&frames[index]);
+    WaylandDisplay::GetInstance()->FlushDisplay();
+  }
+
+  // |duration| is the time left until the next frame is due, 0 if the cursor
+  // doesn't change anymore.
+  if (duration) {
+    animation_timer_.Start(FROM_HERE,
+                           base::TimeDelta::FromMilliseconds(duration),
+                           this,
+                           &WaylandCursor::OnAnimationTimer);
+  }
+}
+
 void WaylandCursor::SetInputPointer(wl_pointer* pointer) {
   if (input_pointer_ == pointer)
     return;
@@ -9,9 +9,36 @@
 #include <wayland-cursor.h>
 
 #include "base/basictypes.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "ui/gfx/geometry/point.h"
+#include "ui/gfx/geometry/size.h"
+
+class SkBitmap;
 
 namespace ozonewayland {
 
+struct WaylandCursorFrame;
+
+// Identifies the image of an image cursor. The hash alone could collide.
+struct WaylandImageCursorKey {
+  WaylandImageCursorKey() : hash(0) {}
+  WaylandImageCursorKey(uint32 hash,
+                        const gfx::Size& size,
+                        const gfx::Point& hotspot)
+      : hash(hash), size(size), hotspot(hotspot) {}
+
+  bool operator==(const WaylandImageCursorKey& other) const {
+    return hash == other.hash && size == other.size &&
+        hotspot == other.hotspot;
+  }
+  bool operator<(const WaylandImageCursorKey& other) const;
+
+  uint32 hash;
+  gfx::Size size;
+  gfx::Point hotspot;
+};
+
 class WaylandCursor {
  public:
   enum CursorType {
@@ -49,15 +76,53 @@ class WaylandCursor {
   // needed. No other class should call this.
   static void Clear();
 
+  // Shows the cursor of |type|. Does nothing if it is already shown for the
+  // pointer focus identified by |serial|. Animated cursors are advanced by a
+  // timer, following the delays of the theme, until the cursor changes.
   void Update(CursorType type, uint32_t serial);
+  // Shows |bitmap| as the cursor. |hash| identifies the image, which is only
+  // uploaded to the compositor the first time it is shown.
+  void UpdateBitmap(uint32 hash,
+                    const SkBitmap& bitmap,
+                    const gfx::Point& hotspot,
+                    uint32_t serial);
+  // Shows the image cursor identified by |hash|, |size| and |hotspot|, which
+  // was shown before. Returns false if the image is no longer cached.
+  bool UpdateCachedBitmap(uint32 hash,
+                          const gfx::Size& size,
+                          const gfx::Point& hotspot,
+                          uint32_t serial);
 
   wl_pointer* GetInputPointer() const { return input_pointer_; }
   void SetInputPointer(wl_pointer* pointer);
 
  private:
+  // Shows the image cursor |frame|, identified by |key|.
+  void ShowImage(const WaylandImageCursorKey& key,
+                 const WaylandCursorFrame* frame,
+                 uint32_t serial);
+  // Attaches |frame| to the pointer surface and commits it.
+  void CommitFrame(const WaylandCursorFrame* frame);
+  void StartAnimation();
+  void CancelAnimation();
+  // Shows the frame of the animated cursor due now, if it changed, and arms
+  // |animation_timer_| for the next one.
+  void OnAnimationTimer();
+
   wl_pointer* input_pointer_;
   struct wl_surface* pointer_surface_;
+
+  // The cursor last asked for, and the one shown for it, which differ when
+  // the theme has no cursor of the type asked for.
   CursorType current_cursor_;
+  CursorType shown_cursor_;
+  // The image cursor shown, if |current_cursor_| is CURSOR_UNSET.
+  WaylandImageCursorKey current_image_;
+  uint32_t current_serial_;
+  size_t current_frame_;
+  // Runs while an animated cursor is shown.
+  base::OneShotTimer<WaylandCursor> animation_timer_;
+  base::TimeTicks animation_start_;
   DISALLOW_COPY_AND_ASSIGN(WaylandCursor);
 };
 
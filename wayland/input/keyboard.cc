@@ -4,17 +4,61 @@
 
 #include "ozone/wayland/input/keyboard.h"
 
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/posix/eintr_wrapper.h"
 #include "ozone/ui/events/event_factory_ozone_wayland.h"
+#include "ozone/wayland/display.h"
 #include "ozone/wayland/input/keyboard_engine_xkb.h"
+#include "ozone/wayland/input_device.h"
+#include "ui/events/event_constants.h"
 
 namespace ozonewayland {
 
-WaylandKeyboard::WaylandKeyboard() : input_keyboard_(NULL),
+namespace {
+
+// Used until the compositor tells us its settings, or if it never does.
+const int32_t kDefaultRepeatRate = 25;
+const int32_t kDefaultRepeatDelayMs = 400;
+
+struct timespec TimespecFromMicroseconds(int64_t us) {
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000;
+  return ts;
+}
+
+}  // namespace
+
+WaylandKeyboard::WaylandKeyboard(WaylandInputDevice* seat) : seat_(seat),
+    input_keyboard_(NULL),
     dispatcher_(NULL),
-    backend_(NULL) {
+    backend_(NULL),
+    repeat_rate_(kDefaultRepeatRate),
+    repeat_delay_(kDefaultRepeatDelayMs),
+    repeat_timer_fd_(timerfd_create(CLOCK_MONOTONIC,
+                                    TFD_CLOEXEC | TFD_NONBLOCK)),
+    repeat_timer_watched_(false),
+    repeat_key_active_(false),
+    repeat_key_(0) {
+  if (repeat_timer_fd_ < 0)
+    PLOG(ERROR) << "Failed to create the key repeat timer";
 }
 
 WaylandKeyboard::~WaylandKeyboard() {
+  // Once the poll thread stops watching the timer it can't notify us anymore,
+  // even if we are destroyed on another thread. |repeat_timer_watched_| is
+  // set on the poll thread, so don't rely on it here.
+  if (repeat_timer_fd_ >= 0) {
+    WaylandDisplay* display = WaylandDisplay::GetInstance();
+    if (display && display->GetPollThread())
+      display->GetPollThread()->StopWatchingFileDescriptor(repeat_timer_fd_);
+    close(repeat_timer_fd_);
+  }
+
   delete backend_;
 
   if (input_keyboard_)
@@ -28,6 +72,9 @@ void WaylandKeyboard::OnSeatCapabilities(wl_seat *seat, uint32_t caps) {
     WaylandKeyboard::OnKeyboardLeave,
     WaylandKeyboard::OnKeyNotify,
     WaylandKeyboard::OnKeyModifiers,
+#if defined(WL_KEYBOARD_REPEAT_INFO_SINCE_VERSION)
+    WaylandKeyboard::OnKeyRepeatInfo,
+#endif
   };
 
   dispatcher_ = ui::EventFactoryOzoneWayland::GetInstance()->EventConverter();
@@ -39,6 +86,7 @@ void WaylandKeyboard::OnSeatCapabilities(wl_seat *seat, uint32_t caps) {
     wl_keyboard_add_listener(input_keyboard_, &kInputKeyboardListener,
         this);
   } else if (!(caps & WL_SEAT_CAPABILITY_KEYBOARD) && input_keyboard_) {
+    CancelKeyRepeat();
     if (backend_) {
       delete backend_;
       backend_ = NULL;
@@ -57,17 +105,26 @@ void WaylandKeyboard::OnKeyNotify(void* data,
                                   uint32_t state) {
   WaylandKeyboard* device = static_cast<WaylandKeyboard*>(data);
   ui::EventType type = ui::ET_KEY_PRESSED;
-  WaylandDisplay::GetInstance()->SetSerial(serial);
+  device->seat_->SetSerial(serial);
   if (state == WL_KEYBOARD_KEY_STATE_RELEASED)
     type = ui::ET_KEY_RELEASED;
 
+  // Pressing another repeating key takes over the repeat below. Modifiers
+  // don't repeat and leave it running.
+  if (type == ui::ET_KEY_RELEASED && device->repeat_key_ == key)
+    device->CancelKeyRepeat();
+
   // Check if we can ignore the KeyEvent notification, saves an IPC call.
   if (device->backend_->IgnoreKeyNotify(key, type == ui::ET_KEY_PRESSED))
     return;
 
-  device->dispatcher_->KeyNotify(type,
-                                 device->backend_->ConvertKeyCodeFromEvdev(key),
-                                 device->backend_->GetKeyBoardModifiers());
+  ui::ResolvedKeyEvent event =
+      device->backend_->ResolveKeyEvent(type, key, 0, time);
+  event.seat_id = device->seat_->GetId();
+  device->dispatcher_->KeyNotify(event);
+
+  if (type == ui::ET_KEY_PRESSED && device->backend_->KeyRepeats(key))
+    device->StartKeyRepeat(key);
 }
 
 void WaylandKeyboard::OnKeyboardKeymap(void *data,
@@ -87,6 +144,7 @@ void WaylandKeyboard::OnKeyboardKeymap(void *data,
     return;
   }
 
+  device->CancelKeyRepeat();
   device->backend_->OnKeyboardKeymap(fd, size);
   close(fd);
 }
@@ -96,14 +154,18 @@ void WaylandKeyboard::OnKeyboardEnter(void* data,
                                       uint32_t serial,
                                       wl_surface* surface,
                                       wl_array* keys) {
-  WaylandDisplay::GetInstance()->SetSerial(serial);
+  WaylandKeyboard* device = static_cast<WaylandKeyboard*>(data);
+  device->seat_->SetSerial(serial);
+  WaylandDisplay::GetInstance()->SetImeInput(device->seat_);
 }
 
 void WaylandKeyboard::OnKeyboardLeave(void* data,
                                       wl_keyboard* input_keyboard,
                                       uint32_t serial,
                                       wl_surface* surface) {
-  WaylandDisplay::GetInstance()->SetSerial(serial);
+  WaylandKeyboard* device = static_cast<WaylandKeyboard*>(data);
+  device->seat_->SetSerial(serial);
+  device->CancelKeyRepeat();
 }
 
 void WaylandKeyboard::OnKeyModifiers(void *data,
@@ -120,4 +182,76 @@ void WaylandKeyboard::OnKeyModifiers(void *data,
                                    group);
 }
 
+void WaylandKeyboard::OnKeyRepeatInfo(void* data,
+                                      wl_keyboard* keyboard,
+                                      int32_t rate,
+                                      int32_t delay) {
+  WaylandKeyboard* device = static_cast<WaylandKeyboard*>(data);
+  device->CancelKeyRepeat();
+  device->repeat_rate_ = rate;
+  device->repeat_delay_ = delay;
+}
+
+void WaylandKeyboard::OnFileCanReadWithoutBlocking() {
+  uint64_t expirations = 0;
+  if (HANDLE_EINTR(read(repeat_timer_fd_, &expirations,
+                        sizeof(expirations))) != sizeof(expirations)) {
+    return;
+  }
+
+  if (!repeat_key_active_ || !backend_)
+    return;
+
+  // If the poll thread fell behind, send one repeat rather than a burst.
+  // Resolve the key again, modifiers may have changed since it was pressed.
+  ui::ResolvedKeyEvent event = backend_->ResolveKeyEvent(ui::ET_KEY_PRESSED,
+                                                         repeat_key_,
+                                                         ui::EF_IS_REPEAT,
+                                                         0);
+  event.seat_id = seat_->GetId();
+  dispatcher_->KeyNotify(event);
+}
+
+void WaylandKeyboard::StartKeyRepeat(uint32_t key) {
+  if (repeat_timer_fd_ < 0 || repeat_rate_ <= 0)
+    return;
+
+  // The keyboard can come up before the poll thread does, so start watching
+  // the timer the first time it is needed.
+  if (!repeat_timer_watched_) {
+    WaylandDisplayPollThread* poll_thread =
+        WaylandDisplay::GetInstance()->GetPollThread();
+    if (!poll_thread ||
+        !poll_thread->WatchFileDescriptor(repeat_timer_fd_, this)) {
+      return;
+    }
+    repeat_timer_watched_ = true;
+  }
+
+  repeat_key_active_ = true;
+  repeat_key_ = key;
+
+  struct itimerspec spec;
+  // A delay of 0 would disarm the timer.
+  spec.it_value = TimespecFromMicroseconds(
+      static_cast<int64_t>(std::max(repeat_delay_, 1)) * 1000);
+  // Rates that do not divide a second into whole milliseconds would repeat
+  // too fast with a truncated interval.
+  spec.it_interval = TimespecFromMicroseconds(
+      std::max<int64_t>(1000000 / repeat_rate_, 1));
+  if (timerfd_settime(repeat_timer_fd_, 0, &spec, NULL) < 0) {
+    PLOG(ERROR) << "Failed to arm the key repeat timer";
+    repeat_key_active_ = false;
+  }
+}
+
+void WaylandKeyboard::CancelKeyRepeat() {
+  if (!repeat_key_active_)
+    return;
+
+  repeat_key_active_ = false;
+  struct itimerspec spec = {};
+  timerfd_settime(repeat_timer_fd_, 0, &spec, NULL);
+}
+
 }  // namespace ozonewayland
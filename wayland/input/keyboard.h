@@ -8,6 +8,7 @@
 #include <xkbcommon/xkbcommon.h>
 
 #include "ozone/wayland/display.h"
+#include "ozone/wayland/display_poll_thread.h"
 
 namespace ui {
 class EventConverterOzoneWayland;
@@ -16,16 +17,27 @@ class EventConverterOzoneWayland;
 namespace ozonewayland {
 
 class KeyboardEngineXKB;
+class WaylandInputDevice;
 
-class WaylandKeyboard {
+// Key repeat is generated on the client side, at the rate and delay the
+// compositor asks for through wl_keyboard.repeat_info. Repeats are timed by a
+// timerfd polled on the display poll thread, and go through KeyNotify like
+// any other key press, with ui::EF_IS_REPEAT set.
+class WaylandKeyboard : public WaylandDisplayPollThread::Watcher {
  public:
-  WaylandKeyboard();
-  ~WaylandKeyboard();
+  explicit WaylandKeyboard(WaylandInputDevice* seat);
+  virtual ~WaylandKeyboard();
   KeyboardEngineXKB* GetBackend() { return backend_;}
 
   void OnSeatCapabilities(wl_seat *seat, uint32_t caps);
 
+  // WaylandDisplayPollThread::Watcher implementation:
+  virtual void OnFileCanReadWithoutBlocking() OVERRIDE;
+
  private:
+  void StartKeyRepeat(uint32_t key);
+  void CancelKeyRepeat();
+
   static void OnKeyNotify(void* data,
                           wl_keyboard* input_keyboard,
                           uint32_t serial,
@@ -58,10 +70,26 @@ class WaylandKeyboard {
                              uint32_t mods_locked,
                              uint32_t group);
 
+  static void OnKeyRepeatInfo(void* data,
+                              wl_keyboard* keyboard,
+                              int32_t rate,
+                              int32_t delay);
+
+  WaylandInputDevice* seat_;
   wl_keyboard* input_keyboard_;
   ui::EventConverterOzoneWayland* dispatcher_;
   KeyboardEngineXKB* backend_;
 
+  // Repeats per second, 0 disables key repeat, and delay in milliseconds
+  // before the first one.
+  int32_t repeat_rate_;
+  int32_t repeat_delay_;
+  int repeat_timer_fd_;
+  bool repeat_timer_watched_;
+  // The evdev code of the key being repeated, if |repeat_key_active_|.
+  bool repeat_key_active_;
+  uint32_t repeat_key_;
+
   DISALLOW_COPY_AND_ASSIGN(WaylandKeyboard);
 };
 
@@ -6,18 +6,33 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+
+#include "ozone/ui/events/keyboard_code_conversion_ozone.h"
 #include "ozone/ui/events/keyboard_codes_ozone.h"
 #include "ui/events/event.h"
+#include "ui/events/keycodes/dom4/keycode_converter.h"
 
 namespace ozonewayland {
 
+// Few keys have more than Shift, AltGr and Shift+AltGr levels. The odd key
+// with more is resolved through xkbcommon instead of the table.
+const xkb_level_index_t kMaxTableLevels = 8;
+
+KeyboardEngineXKB::KeyInfo::KeyInfo()
+    : keysym(ui::OZONECHARCODE_NULL),
+      key_code(ui::VKEY_UNKNOWN),
+      code(""),
+      character(0) {
+}
+
 KeyboardEngineXKB::KeyboardEngineXKB() : keyboard_modifiers_(0),
     mods_depressed_(0),
     mods_latched_(0),
     mods_locked_(0),
     group_(0),
-    last_key_(-1),
-    cached_sym_(XKB_KEY_NoSymbol),
+    min_keycode_(0),
+    table_levels_(0),
     keymap_(NULL),
     state_(NULL),
     context_(NULL) {
@@ -34,6 +49,12 @@ void KeyboardEngineXKB::OnKeyboardKeymap(int fd, uint32_t size) {
     return;
 
   InitXKB();
+  if (state_) {
+    xkb_state_unref(state_);
+    state_ = NULL;
+  }
+  key_table_.clear();
+
   keymap_ = xkb_map_new_from_string(context_,
                                     map_str,
                                     XKB_KEYMAP_FORMAT_TEXT_V1,
@@ -46,6 +67,10 @@ void KeyboardEngineXKB::OnKeyboardKeymap(int fd, uint32_t size) {
   if (state_) {
     xkb_map_unref(keymap_);
     keymap_ = NULL;
+    // The new state starts out with no modifiers set.
+    mods_depressed_ = mods_latched_ = mods_locked_ = group_ = 0;
+    keyboard_modifiers_ = 0;
+    BuildKeyTable();
   }
 }
 
@@ -61,6 +86,7 @@ void KeyboardEngineXKB::OnKeyModifiers(uint32_t mods_depressed,
     return;
   }
 
+  bool group_changed = group_ != group;
   mods_depressed_ = mods_depressed;
   mods_locked_ = mods_locked;
   mods_latched_ = mods_latched;
@@ -72,6 +98,8 @@ void KeyboardEngineXKB::OnKeyModifiers(uint32_t mods_depressed,
                         0,
                         0,
                         group_);
+  if (group_changed)
+    BuildKeyTable();
 
   keyboard_modifiers_ = 0;
   if (xkb_state_mod_name_is_active(
@@ -92,23 +120,46 @@ void KeyboardEngineXKB::OnKeyModifiers(uint32_t mods_depressed,
 }
 
 unsigned KeyboardEngineXKB::ConvertKeyCodeFromEvdev(unsigned hardwarecode) {
-  if (hardwarecode == last_key_)
-    return cached_sym_;
-
-  const xkb_keysym_t *syms;
-  xkb_keysym_t sym;
-  uint32_t code = hardwarecode + 8;
-  uint32_t num_syms = xkb_key_get_syms(state_, code, &syms);
-  if (num_syms == 1)
-    sym = syms[0];
-  else
-    sym = XKB_KEY_NoSymbol;
+  return LookupKey(hardwarecode).keysym;
+}
+
+KeyboardEngineXKB::KeyInfo KeyboardEngineXKB::LookupKey(
+    unsigned hardwarecode) const {
+  if (!state_)
+    return KeyInfo();
+
+  xkb_keycode_t code = hardwarecode + 8;
+  xkb_layout_index_t layout = xkb_state_key_get_layout(state_, code);
+  xkb_level_index_t level = xkb_state_key_get_level(state_, code, layout);
+  if (code >= min_keycode_ && level < table_levels_) {
+    size_t index = (code - min_keycode_) * table_levels_ + level;
+    if (index < key_table_.size())
+      return key_table_[index];
+  }
 
-  last_key_ = hardwarecode;
-  cached_sym_ = sym;
-  NormalizeKey();
+  const xkb_keysym_t* syms;
+  int num_syms = xkb_state_key_get_syms(state_, code, &syms);
+  return ResolveKeysym(code, num_syms == 1 ? syms[0] : XKB_KEY_NoSymbol);
+}
 
-  return cached_sym_;
+ui::ResolvedKeyEvent KeyboardEngineXKB::ResolveKeyEvent(ui::EventType type,
+                                                        unsigned hardwarecode,
+                                                        int flags,
+                                                        uint32_t time) const {
+  KeyInfo info = LookupKey(hardwarecode);
+  ui::ResolvedKeyEvent event;
+  event.type = type;
+  event.key_code = info.key_code;
+  event.code = info.code;
+  event.flags = keyboard_modifiers_ | flags;
+  // Control characters depend on more than the shift level.
+  if (event.flags & ui::EF_CONTROL_DOWN)
+    event.character = ui::CharacterCodeFromNativeKeySym(info.keysym,
+                                                        event.flags);
+  else
+    event.character = info.character;
+  event.time_stamp = time;
+  return event;
 }
 
 bool KeyboardEngineXKB::IgnoreKeyNotify(
@@ -127,6 +178,67 @@ bool KeyboardEngineXKB::IgnoreKeyNotify(
   return false;
 }
 
+bool KeyboardEngineXKB::KeyRepeats(unsigned hardwarecode) const {
+  if (!state_)
+    return false;
+
+  return xkb_keymap_key_repeats(xkb_state_get_keymap(state_),
+                                hardwarecode + 8);
+}
+
+void KeyboardEngineXKB::BuildKeyTable() {
+  key_table_.clear();
+  struct xkb_keymap* keymap = xkb_state_get_keymap(state_);
+  min_keycode_ = xkb_keymap_min_keycode(keymap);
+  xkb_keycode_t max_keycode = xkb_keymap_max_keycode(keymap);
+  if (max_keycode < min_keycode_)
+    return;
+
+  // Keys may be in a different layout than |group_| when they have fewer
+  // layouts than the keymap, xkb_state_key_get_layout() wraps those.
+  table_levels_ = 1;
+  for (xkb_keycode_t code = min_keycode_; code <= max_keycode; ++code) {
+    xkb_layout_index_t layout = xkb_state_key_get_layout(state_, code);
+    if (layout == XKB_LAYOUT_INVALID)
+      continue;
+    table_levels_ = std::max(table_levels_,
+        xkb_keymap_num_levels_for_key(keymap, code, layout));
+  }
+  table_levels_ = std::min(table_levels_, kMaxTableLevels);
+
+  key_table_.resize((max_keycode - min_keycode_ + 1) * table_levels_);
+  for (xkb_keycode_t code = min_keycode_; code <= max_keycode; ++code) {
+    xkb_layout_index_t layout = xkb_state_key_get_layout(state_, code);
+    if (layout == XKB_LAYOUT_INVALID)
+      continue;
+
+    xkb_level_index_t num_levels = std::min(table_levels_,
+        xkb_keymap_num_levels_for_key(keymap, code, layout));
+    for (xkb_level_index_t level = 0; level < num_levels; ++level) {
+      const xkb_keysym_t* syms;
+      int num_syms = xkb_keymap_key_get_syms_by_level(
+          keymap, code, layout, level, &syms);
+      key_table_[(code - min_keycode_) * table_levels_ + level] =
+          ResolveKeysym(code, num_syms == 1 ? syms[0] : XKB_KEY_NoSymbol);
+    }
+  }
+}
+
+// static
+KeyboardEngineXKB::KeyInfo KeyboardEngineXKB::ResolveKeysym(
+    xkb_keycode_t code,
+    xkb_keysym_t sym) {
+  KeyInfo info;
+  const char* dom_code =
+      ui::KeycodeConverter::GetInstance()->NativeKeycodeToCode(code);
+  if (dom_code)
+    info.code = dom_code;
+  info.keysym = NormalizeKey(sym);
+  info.key_code = ui::KeyboardCodeFromNativeKeysym(info.keysym);
+  info.character = ui::CharacterCodeFromNativeKeySym(info.keysym, 0);
+  return info;
+}
+
 void KeyboardEngineXKB::InitXKB() {
   if (context_)
     return;
@@ -135,6 +247,7 @@ void KeyboardEngineXKB::InitXKB() {
 }
 
 void KeyboardEngineXKB::FiniXKB() {
+  key_table_.clear();
   if (state_) {
     xkb_state_unref(state_);
     state_ = NULL;
@@ -174,357 +287,360 @@ bool KeyboardEngineXKB::IsOnlyCapsLocked() const {
   return true;
 }
 
-void KeyboardEngineXKB::NormalizeKey() {
-  if ((cached_sym_ >= XKB_KEY_A && cached_sym_ <= XKB_KEY_Z) ||
-       (cached_sym_ >= XKB_KEY_a && cached_sym_ <= XKB_KEY_z) ||
-         (cached_sym_ >= XKB_KEY_0 && cached_sym_ <= XKB_KEY_9))
-    return;
+// static
+unsigned KeyboardEngineXKB::NormalizeKey(xkb_keysym_t sym) {
+  if ((sym >= XKB_KEY_A && sym <= XKB_KEY_Z) ||
+       (sym >= XKB_KEY_a && sym <= XKB_KEY_z) ||
+         (sym >= XKB_KEY_0 && sym <= XKB_KEY_9))
+    return sym;
 
-  if (cached_sym_ >= XKB_KEY_KP_0 && cached_sym_ <= XKB_KEY_KP_9) {
+  if (sym >= XKB_KEY_KP_0 && sym <= XKB_KEY_KP_9) {
     // Numpad Number-keys can be represented by a keysym value of 0-9 nos.
-    cached_sym_ = XKB_KEY_0 + (cached_sym_ - XKB_KEY_KP_0);
-  } else if (cached_sym_ > 0x01000100 && cached_sym_ < 0x01ffffff) {
+    sym = XKB_KEY_0 + (sym - XKB_KEY_KP_0);
+  } else if (sym > 0x01000100 && sym < 0x01ffffff) {
     // Any UCS character in this range will simply be the character's
     // Unicode number plus 0x01000000.
-    cached_sym_ = cached_sym_ - 0x001000000;
-  } else if (cached_sym_ >= XKB_KEY_F1 && cached_sym_ <= XKB_KEY_F24) {
-    cached_sym_ = ui::OZONEACTIONKEY_F1 + (cached_sym_ - XKB_KEY_F1);
-  } else if (cached_sym_ >= XKB_KEY_KP_F1 && cached_sym_ <= XKB_KEY_KP_F4) {
-      cached_sym_ = ui::OZONEACTIONKEY_F1 + (cached_sym_ - XKB_KEY_KP_F1);
+    sym = sym - 0x001000000;
+  } else if (sym >= XKB_KEY_F1 && sym <= XKB_KEY_F24) {
+    sym = ui::OZONEACTIONKEY_F1 + (sym - XKB_KEY_F1);
+  } else if (sym >= XKB_KEY_KP_F1 && sym <= XKB_KEY_KP_F4) {
+      sym = ui::OZONEACTIONKEY_F1 + (sym - XKB_KEY_KP_F1);
   } else {
-      switch (cached_sym_) {
+      switch (sym) {
         case XKB_KEY_dead_circumflex:
-          cached_sym_ = ui::OZONECHARCODE_CARET_CIRCUMFLEX;
+          sym = ui::OZONECHARCODE_CARET_CIRCUMFLEX;
           break;
         case XKB_KEY_dead_diaeresis:
-          cached_sym_ = ui::OZONECHARCODE_SPACING_DIAERESIS;
+          sym = ui::OZONECHARCODE_SPACING_DIAERESIS;
           break;
         case XKB_KEY_dead_perispomeni:
-          cached_sym_ = ui::OZONECHARCODE_TILDE;
+          sym = ui::OZONECHARCODE_TILDE;
           break;
         case XKB_KEY_dead_acute:
-          cached_sym_ = ui::OZONECHARCODE_SPACING_ACUTE;
+          sym = ui::OZONECHARCODE_SPACING_ACUTE;
           break;
         case XKB_KEY_dead_grave:
-          cached_sym_ = ui::OZONECHARCODE_GRAVE_ASSCENT;
+          sym = ui::OZONECHARCODE_GRAVE_ASSCENT;
           break;
         case XKB_KEY_endash:
-          cached_sym_ = ui::OZONECHARCODE_ENDASH;
+          sym = ui::OZONECHARCODE_ENDASH;
           break;
         case XKB_KEY_singlelowquotemark:
-          cached_sym_ = ui::OZONECHARCODE_SINGLE_LOW_QUOTATION_MARK;
+          sym = ui::OZONECHARCODE_SINGLE_LOW_QUOTATION_MARK;
           break;
         case XKB_KEY_dead_cedilla:
-          cached_sym_ = ui::OZONECHARCODE_SPACING_CEDILLA;
+          sym = ui::OZONECHARCODE_SPACING_CEDILLA;
           break;
         case XKB_KEY_KP_Equal:
-          cached_sym_ = ui::OZONECHARCODE_EQUAL;
+          sym = ui::OZONECHARCODE_EQUAL;
           break;
         case XKB_KEY_KP_Multiply:
-          cached_sym_ = ui::OZONECHARCODE_MULTIPLY;
+          sym = ui::OZONECHARCODE_MULTIPLY;
           break;
         case XKB_KEY_KP_Add:
-          cached_sym_ = ui::OZONECHARCODE_PLUS;
+          sym = ui::OZONECHARCODE_PLUS;
           break;
         case XKB_KEY_KP_Separator:
-          cached_sym_ = ui::OZONECHARCODE_COMMA;
+          sym = ui::OZONECHARCODE_COMMA;
           break;
         case XKB_KEY_KP_Subtract:
-          cached_sym_ = ui::OZONECHARCODE_MINUS;
+          sym = ui::OZONECHARCODE_MINUS;
           break;
         case XKB_KEY_KP_Decimal:
-          cached_sym_ = ui::OZONECHARCODE_PERIOD;
+          sym = ui::OZONECHARCODE_PERIOD;
           break;
         case XKB_KEY_KP_Divide:
-          cached_sym_ = ui::OZONECHARCODE_DIVISION;
+          sym = ui::OZONECHARCODE_DIVISION;
           break;
         case XKB_KEY_Delete:
         case XKB_KEY_KP_Delete:
-          cached_sym_ = ui::OZONEACTIONKEY_DELETE;
+          sym = ui::OZONEACTIONKEY_DELETE;
           break;
         case XKB_KEY_KP_Tab:
         case XKB_KEY_ISO_Left_Tab:
         case XKB_KEY_Tab:
         case XKB_KEY_3270_BackTab:
-          cached_sym_ = ui::OZONEACTIONKEY_TAB;
+          sym = ui::OZONEACTIONKEY_TAB;
           break;
         case XKB_KEY_Sys_Req:
         case XKB_KEY_Escape:
-          cached_sym_ = ui::OZONEACTIONKEY_ESCAPE;
+          sym = ui::OZONEACTIONKEY_ESCAPE;
           break;
         case XKB_KEY_Linefeed:
-          cached_sym_ = ui::OZONECHARCODE_LINEFEED;
+          sym = ui::OZONECHARCODE_LINEFEED;
           break;
         case XKB_KEY_Return:
         case XKB_KEY_KP_Enter:
         case XKB_KEY_ISO_Enter:
-          cached_sym_ = ui::OZONEACTIONKEY_RETURN;
+          sym = ui::OZONEACTIONKEY_RETURN;
           break;
         case XKB_KEY_KP_Space:
         case XKB_KEY_space:
-          cached_sym_ = ui::OZONEACTIONKEY_SPACE;
+          sym = ui::OZONEACTIONKEY_SPACE;
           break;
         case XKB_KEY_dead_caron:
-          cached_sym_ = ui::OZONECHARCODE_CARON;
+          sym = ui::OZONECHARCODE_CARON;
           break;
         case XKB_KEY_BackSpace:
-          cached_sym_ = ui::OZONEACTIONKEY_BACK;
+          sym = ui::OZONEACTIONKEY_BACK;
           break;
         case XKB_KEY_dead_doubleacute:
-          cached_sym_ = ui::OZONECHARCODE_DOUBLE_ACUTE_ACCENT;
+          sym = ui::OZONECHARCODE_DOUBLE_ACUTE_ACCENT;
           break;
         case XKB_KEY_dead_horn:
-          cached_sym_ = ui::OZONECHARCODE_COMBINING_HORN;
+          sym = ui::OZONECHARCODE_COMBINING_HORN;
           break;
         case XKB_KEY_oe:
-          cached_sym_ = ui::OZONECHARCODE_LSMALL_OE;
+          sym = ui::OZONECHARCODE_LSMALL_OE;
           break;
         case XKB_KEY_OE:
-          cached_sym_ = ui::OZONECHARCODE_LOE;
+          sym = ui::OZONECHARCODE_LOE;
           break;
         case XKB_KEY_idotless:
-          cached_sym_ = ui::OZONECHARCODE_LSMALL_DOT_LESS_I;
+          sym = ui::OZONECHARCODE_LSMALL_DOT_LESS_I;
           break;
         case XKB_KEY_kra:
-          cached_sym_ = ui::OZONECHARCODE_LSMALL_KRA;
+          sym = ui::OZONECHARCODE_LSMALL_KRA;
           break;
         case XKB_KEY_dead_stroke:
-          cached_sym_ = ui::OZONECHARCODE_MINUS;
+          sym = ui::OZONECHARCODE_MINUS;
           break;
         case XKB_KEY_eng:
-          cached_sym_ = ui::OZONECHARCODE_LSMALL_ENG;
+          sym = ui::OZONECHARCODE_LSMALL_ENG;
           break;
         case XKB_KEY_ENG:
-          cached_sym_ = ui::OZONECHARCODE_LENG;
+          sym = ui::OZONECHARCODE_LENG;
           break;
         case XKB_KEY_leftsinglequotemark:
-          cached_sym_ = ui::OZONECHARCODE_LEFT_SINGLE_QUOTATION_MARK;
+          sym = ui::OZONECHARCODE_LEFT_SINGLE_QUOTATION_MARK;
           break;
         case XKB_KEY_rightsinglequotemark:
-          cached_sym_ = ui::OZONECHARCODE_RIGHT_SINGLE_QUOTATION_MARK;
+          sym = ui::OZONECHARCODE_RIGHT_SINGLE_QUOTATION_MARK;
           break;
         case XKB_KEY_dead_belowdot:
-          cached_sym_ = ui::OZONECHARCODE_COMBINING_DOT_BELOW;
+          sym = ui::OZONECHARCODE_COMBINING_DOT_BELOW;
           break;
         case XKB_KEY_dead_belowdiaeresis:
-          cached_sym_ = ui::OZONECHARCODE_COMBINING_DIAERESIS_BELOW;
+          sym = ui::OZONECHARCODE_COMBINING_DIAERESIS_BELOW;
           break;
         case XKB_KEY_Clear:
         case XKB_KEY_KP_Begin:
-          cached_sym_ = ui::OZONEACTIONKEY_CLEAR;
+          sym = ui::OZONEACTIONKEY_CLEAR;
           break;
         case XKB_KEY_Home:
         case XKB_KEY_KP_Home:
-          cached_sym_ = ui::OZONEACTIONKEY_HOME;
+          sym = ui::OZONEACTIONKEY_HOME;
           break;
         case XKB_KEY_End:
         case XKB_KEY_KP_End:
-          cached_sym_ = ui::OZONEACTIONKEY_END;
+          sym = ui::OZONEACTIONKEY_END;
           break;
         case XKB_KEY_Page_Up:
         case XKB_KEY_KP_Page_Up:  // aka XKB_KEY_KP_Prior
-          cached_sym_ = ui::OZONEACTIONKEY_PRIOR;
+          sym = ui::OZONEACTIONKEY_PRIOR;
           break;
         case XKB_KEY_Page_Down:
         case XKB_KEY_KP_Page_Down:  // aka XKB_KEY_KP_Next
-          cached_sym_ = ui::OZONEACTIONKEY_NEXT;
+          sym = ui::OZONEACTIONKEY_NEXT;
           break;
         case XKB_KEY_Left:
         case XKB_KEY_KP_Left:
-          cached_sym_ = ui::OZONEACTIONKEY_LEFT;
+          sym = ui::OZONEACTIONKEY_LEFT;
           break;
         case XKB_KEY_Right:
         case XKB_KEY_KP_Right:
-          cached_sym_ = ui::OZONEACTIONKEY_RIGHT;
+          sym = ui::OZONEACTIONKEY_RIGHT;
           break;
         case XKB_KEY_Down:
         case XKB_KEY_KP_Down:
-          cached_sym_ = ui::OZONEACTIONKEY_DOWN;
+          sym = ui::OZONEACTIONKEY_DOWN;
           break;
         case XKB_KEY_Up:
         case XKB_KEY_KP_Up:
-          cached_sym_ = ui::OZONEACTIONKEY_UP;
+          sym = ui::OZONEACTIONKEY_UP;
           break;
         case XKB_KEY_Kana_Lock:
         case XKB_KEY_Kana_Shift:
-          cached_sym_ = ui::OZONEACTIONKEY_KANA;
+          sym = ui::OZONEACTIONKEY_KANA;
           break;
         case XKB_KEY_Hangul:
-          cached_sym_ = ui::OZONEACTIONKEY_HANGUL;
+          sym = ui::OZONEACTIONKEY_HANGUL;
           break;
         case XKB_KEY_Hangul_Hanja:
-          cached_sym_ = ui::OZONEACTIONKEY_HANJA;
+          sym = ui::OZONEACTIONKEY_HANJA;
           break;
         case XKB_KEY_Kanji:
-          cached_sym_ = ui::OZONEACTIONKEY_KANJI;
+          sym = ui::OZONEACTIONKEY_KANJI;
           break;
         case XKB_KEY_Henkan:
-          cached_sym_ = ui::OZONEACTIONKEY_CONVERT;
+          sym = ui::OZONEACTIONKEY_CONVERT;
           break;
         case XKB_KEY_Muhenkan:
-          cached_sym_ = ui::OZONEACTIONKEY_NONCONVERT;
+          sym = ui::OZONEACTIONKEY_NONCONVERT;
           break;
         case XKB_KEY_Zenkaku_Hankaku:
-          cached_sym_ = ui::OZONEACTIONKEY_DBE_DBCSCHAR;
+          sym = ui::OZONEACTIONKEY_DBE_DBCSCHAR;
           break;
         case XKB_KEY_ISO_Level5_Shift:
-          cached_sym_ = ui::OZONEACTIONKEY_OEM_8;
+          sym = ui::OZONEACTIONKEY_OEM_8;
           break;
         case XKB_KEY_Shift_L:
         case XKB_KEY_Shift_R:
-          cached_sym_ = ui::OZONEACTIONKEY_SHIFT;
+          sym = ui::OZONEACTIONKEY_SHIFT;
           break;
         case XKB_KEY_Control_L:
         case XKB_KEY_Control_R:
-          cached_sym_ = ui::OZONEACTIONKEY_CONTROL;
+          sym = ui::OZONEACTIONKEY_CONTROL;
           break;
         case XKB_KEY_Meta_L:
         case XKB_KEY_Meta_R:
         case XKB_KEY_Alt_L:
         case XKB_KEY_Alt_R:
-          cached_sym_ = ui::OZONEACTIONKEY_MENU;
+          sym = ui::OZONEACTIONKEY_MENU;
           break;
         case XKB_KEY_ISO_Level3_Shift:
-          cached_sym_ = ui::OZONEACTIONKEY_ALTGR;
+          sym = ui::OZONEACTIONKEY_ALTGR;
           break;
         case XKB_KEY_Multi_key:
-          cached_sym_ = 0xE6;
+          sym = 0xE6;
           break;
         case XKB_KEY_Pause:
-          cached_sym_ = ui::OZONEACTIONKEY_PAUSE;
+          sym = ui::OZONEACTIONKEY_PAUSE;
           break;
         case XKB_KEY_Caps_Lock:
-          cached_sym_ = ui::OZONEACTIONKEY_CAPITAL;
+          sym = ui::OZONEACTIONKEY_CAPITAL;
           break;
         case XKB_KEY_Num_Lock:
-          cached_sym_ = ui::OZONEACTIONKEY_NUMLOCK;
+          sym = ui::OZONEACTIONKEY_NUMLOCK;
           break;
         case XKB_KEY_Scroll_Lock:
-          cached_sym_ = ui::OZONEACTIONKEY_SCROLL;
+          sym = ui::OZONEACTIONKEY_SCROLL;
           break;
         case XKB_KEY_Select:
-          cached_sym_ = ui::OZONEACTIONKEY_SELECT;
+          sym = ui::OZONEACTIONKEY_SELECT;
           break;
         case XKB_KEY_Print:
-          cached_sym_ = ui::OZONEACTIONKEY_PRINT;
+          sym = ui::OZONEACTIONKEY_PRINT;
           break;
         case XKB_KEY_Execute:
-          cached_sym_ = ui::OZONEACTIONKEY_EXECUTE;
+          sym = ui::OZONEACTIONKEY_EXECUTE;
           break;
         case XKB_KEY_Insert:
         case XKB_KEY_KP_Insert:
-          cached_sym_ = ui::OZONEACTIONKEY_INSERT;
+          sym = ui::OZONEACTIONKEY_INSERT;
           break;
         case XKB_KEY_Help:
-          cached_sym_ = ui::OZONEACTIONKEY_HELP;
+          sym = ui::OZONEACTIONKEY_HELP;
           break;
         case XKB_KEY_Super_L:
-          cached_sym_ = ui::OZONEACTIONKEY_LWIN;
+          sym = ui::OZONEACTIONKEY_LWIN;
           break;
         case XKB_KEY_Super_R:
-          cached_sym_ = ui::OZONEACTIONKEY_RWIN;
+          sym = ui::OZONEACTIONKEY_RWIN;
           break;
         case XKB_KEY_Menu:
-          cached_sym_ = ui::OZONEACTIONKEY_APPS;
+          sym = ui::OZONEACTIONKEY_APPS;
           break;
         case XKB_KEY_XF86Tools:
-          cached_sym_ = ui::OZONEACTIONKEY_F13;
+          sym = ui::OZONEACTIONKEY_F13;
           break;
         case XKB_KEY_XF86Launch5:
-          cached_sym_ = ui::OZONEACTIONKEY_F14;
+          sym = ui::OZONEACTIONKEY_F14;
           break;
         case XKB_KEY_XF86Launch6:
-          cached_sym_ = ui::OZONEACTIONKEY_F15;
+          sym = ui::OZONEACTIONKEY_F15;
           break;
         case XKB_KEY_XF86Launch7:
-          cached_sym_ = ui::OZONEACTIONKEY_F16;
+          sym = ui::OZONEACTIONKEY_F16;
           break;
         case XKB_KEY_XF86Launch8:
-          cached_sym_ = ui::OZONEACTIONKEY_F17;
+          sym = ui::OZONEACTIONKEY_F17;
           break;
         case XKB_KEY_XF86Launch9:
-          cached_sym_ = ui::OZONEACTIONKEY_F18;
+          sym = ui::OZONEACTIONKEY_F18;
           break;
 
         // For supporting multimedia buttons on a USB keyboard.
         case XKB_KEY_XF86Back:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_BACK;
+          sym = ui::OZONEACTIONKEY_BROWSER_BACK;
           break;
         case XKB_KEY_XF86Forward:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_FORWARD;
+          sym = ui::OZONEACTIONKEY_BROWSER_FORWARD;
           break;
         case XKB_KEY_XF86Reload:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_REFRESH;
+          sym = ui::OZONEACTIONKEY_BROWSER_REFRESH;
           break;
         case XKB_KEY_XF86Stop:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_STOP;
+          sym = ui::OZONEACTIONKEY_BROWSER_STOP;
           break;
         case XKB_KEY_XF86Search:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_SEARCH;
+          sym = ui::OZONEACTIONKEY_BROWSER_SEARCH;
           break;
         case XKB_KEY_XF86Favorites:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_FAVORITES;
+          sym = ui::OZONEACTIONKEY_BROWSER_FAVORITES;
           break;
         case XKB_KEY_XF86HomePage:
-          cached_sym_ = ui::OZONEACTIONKEY_BROWSER_HOME;
+          sym = ui::OZONEACTIONKEY_BROWSER_HOME;
           break;
         case XKB_KEY_XF86AudioMute:
-          cached_sym_ = ui::OZONEACTIONKEY_VOLUME_MUTE;
+          sym = ui::OZONEACTIONKEY_VOLUME_MUTE;
           break;
         case XKB_KEY_XF86AudioLowerVolume:
-          cached_sym_ = ui::OZONEACTIONKEY_VOLUME_DOWN;
+          sym = ui::OZONEACTIONKEY_VOLUME_DOWN;
           break;
         case XKB_KEY_XF86AudioRaiseVolume:
-          cached_sym_ = ui::OZONEACTIONKEY_VOLUME_UP;
+          sym = ui::OZONEACTIONKEY_VOLUME_UP;
           break;
         case XKB_KEY_XF86AudioNext:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_NEXT_TRACK;
+          sym = ui::OZONEACTIONKEY_MEDIA_NEXT_TRACK;
           break;
         case XKB_KEY_XF86AudioPrev:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_PREV_TRACK;
+          sym = ui::OZONEACTIONKEY_MEDIA_PREV_TRACK;
           break;
         case XKB_KEY_XF86AudioStop:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_STOP;
+          sym = ui::OZONEACTIONKEY_MEDIA_STOP;
           break;
         case XKB_KEY_XF86AudioPlay:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_PLAY_PAUSE;
+          sym = ui::OZONEACTIONKEY_MEDIA_PLAY_PAUSE;
           break;
         case XKB_KEY_XF86Mail:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_LAUNCH_MAIL;
+          sym = ui::OZONEACTIONKEY_MEDIA_LAUNCH_MAIL;
           break;
         case XKB_KEY_XF86LaunchA:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_LAUNCH_APP1;
+          sym = ui::OZONEACTIONKEY_MEDIA_LAUNCH_APP1;
           break;
         case XKB_KEY_XF86LaunchB:
         case XKB_KEY_XF86Calculator:
-          cached_sym_ = ui::OZONEACTIONKEY_MEDIA_LAUNCH_APP2;
+          sym = ui::OZONEACTIONKEY_MEDIA_LAUNCH_APP2;
           break;
         case XKB_KEY_XF86WLAN:
-          cached_sym_ = ui::OZONEACTIONKEY_WLAN;
+          sym = ui::OZONEACTIONKEY_WLAN;
           break;
         case XKB_KEY_XF86PowerOff:
-          cached_sym_ = ui::OZONEACTIONKEY_POWER;
+          sym = ui::OZONEACTIONKEY_POWER;
           break;
         case XKB_KEY_XF86MonBrightnessDown:
-          cached_sym_ = ui::OZONEACTIONKEY_BRIGHTNESS_DOWN;
+          sym = ui::OZONEACTIONKEY_BRIGHTNESS_DOWN;
           break;
         case XKB_KEY_XF86MonBrightnessUp:
-          cached_sym_ = ui::OZONEACTIONKEY_BRIGHTNESS_UP;
+          sym = ui::OZONEACTIONKEY_BRIGHTNESS_UP;
           break;
         case XKB_KEY_XF86KbdBrightnessDown:
-          cached_sym_ = ui::OZONEACTIONKEY_KBD_BRIGHTNESS_DOWN;
+          sym = ui::OZONEACTIONKEY_KBD_BRIGHTNESS_DOWN;
           break;
         case XKB_KEY_XF86KbdBrightnessUp:
-          cached_sym_ = ui::OZONEACTIONKEY_KBD_BRIGHTNESS_UP;
+          sym = ui::OZONEACTIONKEY_KBD_BRIGHTNESS_UP;
           break;
         case XKB_KEY_emptyset:
         case XKB_KEY_NoSymbol:
-          cached_sym_ = ui::OZONECHARCODE_NULL;
+          sym = ui::OZONECHARCODE_NULL;
           break;
         default:
           break;
     }
   }
+
+  return sym;
 }
 
 }  // namespace ozonewayland
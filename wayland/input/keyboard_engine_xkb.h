@@ -7,12 +7,33 @@
 
 #include <xkbcommon/xkbcommon.h>
 
+#include <vector>
+
 #include "base/basictypes.h"
+#include "ozone/ui/events/resolved_key_event.h"
+#include "ui/events/keycodes/keyboard_codes.h"
 
 namespace ozonewayland {
 
+// Translates evdev key codes with the keymap sent by the compositor. What
+// every key produces at every shift level of the active layout is resolved
+// once per keymap and layout change, so that translating a key event is a
+// table lookup.
 class KeyboardEngineXKB {
  public:
+  struct KeyInfo {
+    KeyInfo();
+
+    // Ozone keysym.
+    unsigned keysym;
+    ui::KeyboardCode key_code;
+    // DOM code of the key, never NULL.
+    const char* code;
+    // The character typed when Control isn't down, for which
+    // ui::CharacterCodeFromNativeKeySym() is still needed.
+    uint16 character;
+  };
+
   KeyboardEngineXKB();
   ~KeyboardEngineXKB();
 
@@ -22,7 +43,17 @@ class KeyboardEngineXKB {
                       uint32_t mods_locked,
                       uint32_t group);
   unsigned ConvertKeyCodeFromEvdev(unsigned hardwarecode);
+  // Returns what |hardwarecode| produces with the current modifiers.
+  KeyInfo LookupKey(unsigned hardwarecode) const;
+  // Translates a press or release of |hardwarecode| that happened at |time|,
+  // with the current modifiers and |flags|.
+  ui::ResolvedKeyEvent ResolveKeyEvent(ui::EventType type,
+                                       unsigned hardwarecode,
+                                       int flags,
+                                       uint32_t time) const;
   bool IgnoreKeyNotify(unsigned hardwarecode, bool pressed);
+  // Returns whether the keymap wants |hardwarecode| to repeat while held.
+  bool KeyRepeats(unsigned hardwarecode) const;
 
   uint32_t GetKeyBoardModifiers() const { return keyboard_modifiers_; }
 
@@ -31,7 +62,9 @@ class KeyboardEngineXKB {
   void FiniXKB();
   bool IsSpecialModifier(unsigned hardwarecode);
   bool IsOnlyCapsLocked() const;
-  void NormalizeKey();
+  void BuildKeyTable();
+  static KeyInfo ResolveKeysym(xkb_keycode_t code, xkb_keysym_t sym);
+  static unsigned NormalizeKey(xkb_keysym_t sym);
 
   // Keeps track of the currently active keyboard modifiers. We keep this
   // since we want to advertise keyboard modifiers with mouse events.
@@ -40,8 +73,11 @@ class KeyboardEngineXKB {
   uint32_t mods_latched_;
   uint32_t mods_locked_;
   uint32_t group_;
-  int last_key_;
-  xkb_keysym_t cached_sym_;
+
+  // Indexed by (keycode - |min_keycode_|) * |table_levels_| + shift level.
+  std::vector<KeyInfo> key_table_;
+  xkb_keycode_t min_keycode_;
+  xkb_level_index_t table_levels_;
 
   // keymap used to transform keyboard events.
   struct xkb_keymap *keymap_;
@@ -9,21 +9,44 @@
 #include "ozone/ui/events/event_factory_ozone_wayland.h"
 #include "ozone/wayland/input/cursor.h"
 #include "ozone/wayland/input_device.h"
+#include "ozone/wayland/shell/shell_surface.h"
 #include "ozone/wayland/window.h"
 #include "ui/events/event.h"
 
 namespace ozonewayland {
 
-WaylandPointer::WaylandPointer()
-  : cursor_(NULL),
+namespace {
+
+// A scroll which paused for longer than this before the fingers left the
+// touchpad doesn't fling.
+const uint32_t kFlingTimeoutMs = 50;
+// Weight of the latest update in the scroll velocity.
+const float kScrollVelocitySmoothing = 0.5f;
+
+}  // namespace
+
+WaylandPointer::WaylandPointer(WaylandInputDevice* seat)
+  : seat_(seat),
+    cursor_(NULL),
     dispatcher_(NULL),
-    pointer_position_(0, 0) {
+    pointer_position_(0, 0),
+    relative_pointer_(NULL),
+    frame_events_(false),
+    scrolling_(false),
+    last_scroll_time_(0) {
+  ResetAxisFrame();
 }
 
 WaylandPointer::~WaylandPointer() {
+  if (relative_pointer_)
+    zwp_relative_pointer_v1_destroy(relative_pointer_);
   delete cursor_;
 }
 
+wl_pointer* WaylandPointer::GetInputPointer() const {
+  return cursor_ ? cursor_->GetInputPointer() : NULL;
+}
+
 void WaylandPointer::OnSeatCapabilities(wl_seat *seat, uint32_t caps) {
   static const struct wl_pointer_listener kInputPointerListener = {
     WaylandPointer::OnPointerEnter,
@@ -31,6 +54,16 @@ void WaylandPointer::OnSeatCapabilities(wl_seat *seat, uint32_t caps) {
     WaylandPointer::OnMotionNotify,
     WaylandPointer::OnButtonNotify,
     WaylandPointer::OnAxisNotify,
+#if defined(WL_POINTER_FRAME_SINCE_VERSION)
+    WaylandPointer::OnFrame,
+    WaylandPointer::OnAxisSource,
+    WaylandPointer::OnAxisStop,
+    WaylandPointer::OnAxisDiscrete,
+#endif
+  };
+  static const struct zwp_relative_pointer_v1_listener
+      kRelativePointerListener = {
+    WaylandPointer::OnRelativeMotion
   };
 
   if (!cursor_)
@@ -43,8 +76,29 @@ void WaylandPointer::OnSeatCapabilities(wl_seat *seat, uint32_t caps) {
       cursor_->SetInputPointer(input_pointer);
     wl_pointer_set_user_data(input_pointer, this);
     wl_pointer_add_listener(input_pointer, &kInputPointerListener, this);
+#if defined(WL_POINTER_FRAME_SINCE_VERSION)
+    frame_events_ =
+        wl_pointer_get_version(input_pointer) >= WL_POINTER_FRAME_SINCE_VERSION;
+#endif
+    ResetAxisFrame();
+    scrolling_ = false;
+
+    zwp_relative_pointer_manager_v1* relative_pointer_manager =
+        WaylandDisplay::GetInstance()->GetRelativePointerManager();
+    if (relative_pointer_manager) {
+      relative_pointer_ =
+          zwp_relative_pointer_manager_v1_get_relative_pointer(
+              relative_pointer_manager, input_pointer);
+      zwp_relative_pointer_v1_add_listener(relative_pointer_,
+                                           &kRelativePointerListener,
+                                           this);
+    }
   } else if (!(caps & WL_SEAT_CAPABILITY_POINTER)
                 && cursor_->GetInputPointer()) {
+    if (relative_pointer_) {
+      zwp_relative_pointer_v1_destroy(relative_pointer_);
+      relative_pointer_ = NULL;
+    }
     cursor_->SetInputPointer(NULL);
   }
 }
@@ -55,7 +109,7 @@ void WaylandPointer::OnMotionNotify(void* data,
                                     wl_fixed_t sx_w,
                                     wl_fixed_t sy_w) {
   WaylandPointer* device = static_cast<WaylandPointer*>(data);
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
+  WaylandInputDevice* input = device->seat_;
   float sx = wl_fixed_to_double(sx_w);
   float sy = wl_fixed_to_double(sy_w);
 
@@ -65,7 +119,7 @@ void WaylandPointer::OnMotionNotify(void* data,
       return;
   }
 
-  device->dispatcher_->MotionNotify(sx, sy);
+  device->dispatcher_->MotionNotify(sx, sy, time);
 }
 
 void WaylandPointer::OnButtonNotify(void* data,
@@ -75,8 +129,15 @@ void WaylandPointer::OnButtonNotify(void* data,
                                     uint32_t button,
                                     uint32_t state) {
   WaylandPointer* device = static_cast<WaylandPointer*>(data);
-  WaylandDisplay::GetInstance()->SetSerial(serial);
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
+  WaylandInputDevice* input = device->seat_;
+  input->SetSerial(serial);
+  // A press on another window while a popup is open dismisses the popup.
+  if (input->GetGrabWindowHandle() && input->GetGrabButton() == 0 &&
+      input->GetGrabWindowHandle() != input->GetFocusWindowHandle() &&
+      state == WL_POINTER_BUTTON_STATE_PRESSED) {
+    WaylandShellSurface::DismissSubsurfacePopup(input->GetGrabWindowHandle());
+  }
+
   if (input->GetFocusWindowHandle() && input->GetGrabButton() == 0 &&
         state == WL_POINTER_BUTTON_STATE_PRESSED)
     input->SetGrabWindowHandle(input->GetFocusWindowHandle(), button);
@@ -99,7 +160,8 @@ void WaylandPointer::OnButtonNotify(void* data,
                                       type,
                                       flags,
                                       device->pointer_position_.x(),
-                                      device->pointer_position_.y());
+                                      device->pointer_position_.y(),
+                                      time);
   }
 
   if (input->GetGrabWindowHandle() && input->GetGrabButton() == button &&
@@ -116,6 +178,16 @@ void WaylandPointer::OnAxisNotify(void* data,
   WaylandPointer* device = static_cast<WaylandPointer*>(data);
   const int delta = ui::MouseWheelEvent::kWheelDelta;
 
+  if (device->frame_events_) {
+    float distance = wl_fixed_to_double(value);
+    if (axis == WL_POINTER_AXIS_HORIZONTAL_SCROLL)
+      device->axis_delta_.set_x(device->axis_delta_.x() + distance);
+    else if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL)
+      device->axis_delta_.set_y(device->axis_delta_.y() + distance);
+    device->axis_time_ = time;
+    return;
+  }
+
   switch (axis) {
     case WL_POINTER_AXIS_HORIZONTAL_SCROLL:
       x_offset = value > 0 ? -delta : delta;
@@ -130,7 +202,117 @@ void WaylandPointer::OnAxisNotify(void* data,
   device->dispatcher_->AxisNotify(device->pointer_position_.x(),
                                   device->pointer_position_.y(),
                                   x_offset,
-                                  y_offset);
+                                  y_offset,
+                                  time);
+}
+
+#if defined(WL_POINTER_FRAME_SINCE_VERSION)
+void WaylandPointer::OnFrame(void* data, wl_pointer* input_pointer) {
+  WaylandPointer* device = static_cast<WaylandPointer*>(data);
+  device->DispatchAxisFrame();
+}
+
+void WaylandPointer::OnAxisSource(void* data,
+                                  wl_pointer* input_pointer,
+                                  uint32_t axis_source) {
+  WaylandPointer* device = static_cast<WaylandPointer*>(data);
+  device->has_axis_source_ = true;
+  device->axis_source_ = axis_source;
+}
+
+void WaylandPointer::OnAxisStop(void* data,
+                                wl_pointer* input_pointer,
+                                uint32_t time,
+                                uint32_t axis) {
+  WaylandPointer* device = static_cast<WaylandPointer*>(data);
+  device->axis_stop_ = true;
+  device->axis_time_ = time;
+}
+
+void WaylandPointer::OnAxisDiscrete(void* data,
+                                    wl_pointer* input_pointer,
+                                    uint32_t axis,
+                                    int32_t discrete) {
+  WaylandPointer* device = static_cast<WaylandPointer*>(data);
+  if (axis == WL_POINTER_AXIS_HORIZONTAL_SCROLL)
+    device->axis_discrete_x_ += discrete;
+  else if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL)
+    device->axis_discrete_y_ += discrete;
+}
+#endif
+
+void WaylandPointer::DispatchAxisFrame() {
+  float x = pointer_position_.x();
+  float y = pointer_position_.y();
+
+  // Wheels scroll by whole clicks, which the compositor reports as discrete
+  // steps along with the distance.
+  bool wheel = axis_discrete_x_ || axis_discrete_y_;
+#if defined(WL_POINTER_FRAME_SINCE_VERSION)
+  if (has_axis_source_ && axis_source_ == WL_POINTER_AXIS_SOURCE_WHEEL)
+    wheel = true;
+#endif
+
+  if (wheel) {
+    const int delta = ui::MouseWheelEvent::kWheelDelta;
+    int x_offset = -axis_discrete_x_ * delta;
+    int y_offset = -axis_discrete_y_ * delta;
+    // Wheels without clicks report no discrete steps, one step per event is
+    // what older compositors amounted to.
+    if (!x_offset && axis_delta_.x())
+      x_offset = axis_delta_.x() > 0 ? -delta : delta;
+    if (!y_offset && axis_delta_.y())
+      y_offset = axis_delta_.y() > 0 ? -delta : delta;
+    if (x_offset || y_offset)
+      dispatcher_->AxisNotify(x, y, x_offset, y_offset, axis_time_);
+    ResetAxisFrame();
+    return;
+  }
+
+  if (!axis_delta_.IsZero()) {
+    if (!scrolling_) {
+      // Fingers on the touchpad stop any fling still running.
+      dispatcher_->ScrollNotify(ui::ET_SCROLL_FLING_CANCEL, x, y, 0, 0,
+                                axis_time_);
+      scrolling_ = true;
+      scroll_velocity_ = gfx::Vector2dF();
+    } else if (axis_time_ > last_scroll_time_) {
+      gfx::Vector2dF velocity = axis_delta_;
+      velocity.Scale(1.f / (axis_time_ - last_scroll_time_));
+      scroll_velocity_.Scale(1.f - kScrollVelocitySmoothing);
+      velocity.Scale(kScrollVelocitySmoothing);
+      scroll_velocity_ += velocity;
+    }
+    last_scroll_time_ = axis_time_;
+
+    // Wayland scrolls content by positive distances, Chrome by negative
+    // offsets.
+    dispatcher_->ScrollNotify(ui::ET_SCROLL, x, y, -axis_delta_.x(),
+                              -axis_delta_.y(), axis_time_);
+  }
+
+  if (axis_stop_ && scrolling_) {
+    scrolling_ = false;
+    if (axis_time_ - last_scroll_time_ <= kFlingTimeoutMs &&
+        !scroll_velocity_.IsZero()) {
+      dispatcher_->ScrollNotify(ui::ET_SCROLL_FLING_START, x, y,
+                                -scroll_velocity_.x() * 1000,
+                                -scroll_velocity_.y() * 1000,
+                                axis_time_);
+    }
+  }
+
+  ResetAxisFrame();
+}
+
+void WaylandPointer::ResetAxisFrame() {
+  has_axis_source_ = false;
+  axis_source_ = 0;
+  axis_delta_ = gfx::Vector2dF();
+  axis_discrete_x_ = 0;
+  axis_discrete_y_ = 0;
+  axis_stop_ = false;
+  axis_time_ = 0;
 }
 
 void WaylandPointer::OnPointerEnter(void* data,
@@ -139,21 +321,21 @@ void WaylandPointer::OnPointerEnter(void* data,
                                     wl_surface* surface,
                                     wl_fixed_t sx_w,
                                     wl_fixed_t sy_w) {
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
+  WaylandPointer* device = static_cast<WaylandPointer*>(data);
+  WaylandInputDevice* input = device->seat_;
 
   if (!surface) {
     input->SetFocusWindowHandle(0);
     return;
   }
 
-  WaylandPointer* device = static_cast<WaylandPointer*>(data);
   WaylandWindow* window =
       static_cast<WaylandWindow*>(wl_surface_get_user_data(surface));
   unsigned handle = window->Handle();
   float sx = wl_fixed_to_double(sx_w);
   float sy = wl_fixed_to_double(sy_w);
 
-  WaylandDisplay::GetInstance()->SetSerial(serial);
+  input->SetSerial(serial);
   device->pointer_position_.SetPoint(sx, sy);
   input->SetFocusWindowHandle(handle);
   device->dispatcher_->PointerEnter(handle,
@@ -166,13 +348,40 @@ void WaylandPointer::OnPointerLeave(void* data,
                                     uint32_t serial,
                                     wl_surface* surface) {
   WaylandPointer* device = static_cast<WaylandPointer*>(data);
-  WaylandDisplay::GetInstance()->SetSerial(serial);
+  WaylandInputDevice* input = device->seat_;
+  input->SetSerial(serial);
 
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
   device->dispatcher_->PointerLeave(input->GetFocusWindowHandle(),
                                     device->pointer_position_.x(),
                                     device->pointer_position_.y());
   input->SetFocusWindowHandle(0);
 }
 
+void WaylandPointer::OnRelativeMotion(void* data,
+                                      zwp_relative_pointer_v1* relative_pointer,
+                                      uint32_t utime_hi,
+                                      uint32_t utime_lo,
+                                      wl_fixed_t dx,
+                                      wl_fixed_t dy,
+                                      wl_fixed_t dx_unaccel,
+                                      wl_fixed_t dy_unaccel) {
+  // Relative motion comes along with the absolute one, which is all that is
+  // needed unless the pointer is locked.
+  WaylandPointer* device = static_cast<WaylandPointer*>(data);
+  WaylandWindow* window = WaylandDisplay::GetInstance()->GetWindow(
+      device->seat_->GetFocusWindowHandle());
+  if (!window || !window->IsPointerLocked())
+    return;
+
+  // Pointer Lock wants the motion of the device itself, without the
+  // compositor's acceleration.
+  float delta_x = wl_fixed_to_double(dx_unaccel);
+  float delta_y = wl_fixed_to_double(dy_unaccel);
+  device->pointer_position_.Offset(delta_x, delta_y);
+
+  uint64_t utime = (static_cast<uint64_t>(utime_hi) << 32) | utime_lo;
+  device->dispatcher_->RelativeMotionNotify(
+      delta_x, delta_y, static_cast<uint32_t>(utime / 1000));
+}
+
 }  // namespace ozonewayland
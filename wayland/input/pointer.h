@@ -6,7 +6,8 @@
 #define OZONE_WAYLAND_INPUT_POINTER_H_
 
 #include "ozone/wayland/display.h"
-#include "ui/gfx/point.h"
+#include "ui/gfx/point_f.h"
+#include "ui/gfx/vector2d_f.h"
 
 namespace ui {
 class EventConverterOzoneWayland;
@@ -15,15 +16,17 @@ class EventConverterOzoneWayland;
 namespace ozonewayland {
 
 class WaylandCursor;
+class WaylandInputDevice;
 class WaylandWindow;
 
 class WaylandPointer {
  public:
-  WaylandPointer();
+  explicit WaylandPointer(WaylandInputDevice* seat);
   ~WaylandPointer();
 
   void OnSeatCapabilities(wl_seat *seat, uint32_t caps);
   WaylandCursor* Cursor() const { return cursor_; }
+  wl_pointer* GetInputPointer() const;
 
  private:
   static void OnMotionNotify(
@@ -48,6 +51,27 @@ class WaylandPointer {
       uint32_t axis,
       int32_t value);
 
+#if defined(WL_POINTER_FRAME_SINCE_VERSION)
+  static void OnFrame(void* data, wl_pointer* input_pointer);
+
+  static void OnAxisSource(
+      void* data,
+      wl_pointer* input_pointer,
+      uint32_t axis_source);
+
+  static void OnAxisStop(
+      void* data,
+      wl_pointer* input_pointer,
+      uint32_t time,
+      uint32_t axis);
+
+  static void OnAxisDiscrete(
+      void* data,
+      wl_pointer* input_pointer,
+      uint32_t axis,
+      int32_t discrete);
+#endif
+
   static void OnPointerEnter(
       void* data,
       wl_pointer* input_pointer,
@@ -62,12 +86,51 @@ class WaylandPointer {
       uint32_t serial,
       wl_surface* surface);
 
+  static void OnRelativeMotion(
+      void* data,
+      zwp_relative_pointer_v1* relative_pointer,
+      uint32_t utime_hi,
+      uint32_t utime_lo,
+      wl_fixed_t dx,
+      wl_fixed_t dy,
+      wl_fixed_t dx_unaccel,
+      wl_fixed_t dy_unaccel);
+
+  WaylandInputDevice* seat_;
   WaylandCursor* cursor_;
   ui::EventConverterOzoneWayland* dispatcher_;
   // Keeps track of the last position for the motion event. We want to
   // dispatch this with events such as wheel or button which don't have a
   // position associated on Wayland.
-  gfx::Point pointer_position_;
+  // While the pointer is locked, this is where relative motion would have
+  // moved it, so that buttons line up with the motion reported before them.
+  gfx::PointF pointer_position_;
+  // Relative motion of the pointer, if the compositor supports it.
+  zwp_relative_pointer_v1* relative_pointer_;
+
+  // Dispatches the axis events gathered since the last wl_pointer.frame.
+  void DispatchAxisFrame();
+  void ResetAxisFrame();
+
+  // Whether the compositor groups pointer events in frames, with wl_seat
+  // version 5. Axis events are dispatched one by one otherwise.
+  bool frame_events_;
+  // Axis events of the current frame. The source is unknown until the
+  // compositor sends it, which it does at most once per frame.
+  bool has_axis_source_;
+  uint32_t axis_source_;
+  gfx::Vector2dF axis_delta_;
+  int axis_discrete_x_;
+  int axis_discrete_y_;
+  bool axis_stop_;
+  uint32_t axis_time_;
+
+  // Whether a touchpad scroll is in progress, its last update and its
+  // velocity in pixels per millisecond, for the fling started when the
+  // fingers leave the touchpad.
+  bool scrolling_;
+  uint32_t last_scroll_time_;
+  gfx::Vector2dF scroll_velocity_;
 
   DISALLOW_COPY_AND_ASSIGN(WaylandPointer);
 };
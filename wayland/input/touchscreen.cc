@@ -9,17 +9,38 @@
 #include "ozone/ui/events/event_factory_ozone_wayland.h"
 #include "ozone/wayland/input/cursor.h"
 #include "ozone/wayland/input_device.h"
+#include "ozone/wayland/shell/shell_surface.h"
 #include "ozone/wayland/window.h"
 #include "ui/events/event.h"
 
 namespace ozonewayland {
 
-WaylandTouchscreen::WaylandTouchscreen()
-  : dispatcher_(NULL),
-    pointer_position_(0, 0) {
+// Weight of the latest motion in the velocity estimate.
+const float kVelocitySmoothing = 0.5f;
+
+uint32_t WaylandTouchscreen::touch_ids_in_use_ = 0;
+
+WaylandTouchscreen::TouchSlot::TouchSlot()
+    : active(false),
+      id(0),
+      touch_id(0),
+      window_handle(0),
+      start_time(0),
+      last_time(0) {
+}
+
+WaylandTouchscreen::WaylandTouchscreen(WaylandInputDevice* seat)
+  : seat_(seat),
+    dispatcher_(NULL) {
+  // Room for every finger going down in the same frame.
+  pending_updates_.reserve(kMaxTouchPoints);
 }
 
 WaylandTouchscreen::~WaylandTouchscreen() {
+  for (size_t i = 0; i < kMaxTouchPoints; ++i) {
+    if (slots_[i].active)
+      ReleaseSlot(&slots_[i]);
+  }
 }
 
 void WaylandTouchscreen::OnSeatCapabilities(wl_seat *seat, uint32_t caps) {
@@ -49,17 +70,36 @@ void WaylandTouchscreen::OnTouchDown(void *data,
                                      wl_fixed_t x,
                                      wl_fixed_t y) {
   WaylandTouchscreen* device = static_cast<WaylandTouchscreen*>(data);
-  WaylandDisplay::GetInstance()->SetSerial(serial);
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
-  if (input->GetFocusWindowHandle() && input->GetGrabButton() == 0)
-    input->SetGrabWindowHandle(input->GetFocusWindowHandle(), id);
+  device->seat_->SetSerial(serial);
+  if (!surface)
+    return;
 
-  float sx = wl_fixed_to_double(x);
-  float sy = wl_fixed_to_double(y);
+  TouchSlot* slot = device->AllocateSlot(id);
+  if (!slot) {
+    DVLOG(1) << "Ignoring touch point " << id << ", too many points down";
+    return;
+  }
+
+  WaylandWindow* window =
+      static_cast<WaylandWindow*>(wl_surface_get_user_data(surface));
+  slot->window_handle = window->Handle();
+  slot->position.SetPoint(wl_fixed_to_double(x), wl_fixed_to_double(y));
+  slot->start_time = time;
+  slot->last_time = time;
+  slot->velocity = gfx::Vector2dF();
 
-  device->pointer_position_.SetPoint(sx, sy);
+  // Touching another window dismisses an open popup, as with the pointer.
+  WaylandInputDevice* input = device->seat_;
+  if (input->GetGrabWindowHandle() && input->GetGrabButton() == 0 &&
+      input->GetGrabWindowHandle() != slot->window_handle) {
+    WaylandShellSurface::DismissSubsurfacePopup(input->GetGrabWindowHandle());
+  }
 
-  device->dispatcher_->TouchNotify(ui::ET_TOUCH_PRESSED, sx, sy, id, time);
+  device->QueueUpdate(ui::ET_TOUCH_PRESSED,
+                      slot->position.x(),
+                      slot->position.y(),
+                      slot->touch_id,
+                      time);
 }
 
 void WaylandTouchscreen::OnTouchUp(void *data,
@@ -68,15 +108,17 @@ void WaylandTouchscreen::OnTouchUp(void *data,
                                    uint32_t time,
                                    int32_t id) {
   WaylandTouchscreen* device = static_cast<WaylandTouchscreen*>(data);
-  WaylandDisplay::GetInstance()->SetSerial(serial);
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
-
-  device->dispatcher_->TouchNotify(ui::ET_TOUCH_RELEASED,
-                                   device->pointer_position_.x(),
-                                   device->pointer_position_.y(), id, time);
+  device->seat_->SetSerial(serial);
+  TouchSlot* slot = device->FindSlot(id);
+  if (!slot)
+    return;
 
-  if (input->GetGrabWindowHandle() && input->GetGrabButton() == id)
-    input->SetGrabWindowHandle(0, 0);
+  device->QueueUpdate(ui::ET_TOUCH_RELEASED,
+                      slot->position.x(),
+                      slot->position.y(),
+                      slot->touch_id,
+                      time);
+  device->ReleaseSlot(slot);
 }
 
 void WaylandTouchscreen::OnTouchMotion(void *data,
@@ -86,38 +128,151 @@ void WaylandTouchscreen::OnTouchMotion(void *data,
                                       wl_fixed_t x,
                                       wl_fixed_t y) {
   WaylandTouchscreen* device = static_cast<WaylandTouchscreen*>(data);
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
-  float sx = wl_fixed_to_double(x);
-  float sy = wl_fixed_to_double(y);
-
-  device->pointer_position_.SetPoint(sx, sy);
-
-  if (input->GetGrabWindowHandle() &&
-    input->GetGrabWindowHandle() != input->GetFocusWindowHandle()) {
+  TouchSlot* slot = device->FindSlot(id);
+  if (!slot)
     return;
+
+  gfx::PointF position(wl_fixed_to_double(x), wl_fixed_to_double(y));
+  uint32_t elapsed = time - slot->last_time;
+  if (elapsed) {
+    gfx::Vector2dF velocity = position - slot->position;
+    velocity.Scale(1.0f / elapsed);
+    slot->velocity.Scale(1.0f - kVelocitySmoothing);
+    velocity.Scale(kVelocitySmoothing);
+    slot->velocity += velocity;
   }
 
-  device->dispatcher_->TouchNotify(ui::ET_TOUCH_MOVED, sx, sy, id, time);
+  slot->position = position;
+  slot->last_time = time;
+  device->QueueUpdate(ui::ET_TOUCH_MOVED,
+                      position.x(),
+                      position.y(),
+                      slot->touch_id,
+                      time);
 }
 
 void WaylandTouchscreen::OnTouchFrame(void *data,
                                       struct wl_touch *wl_touch) {
-  // TODO(speedpat): find out what should be done here
+  WaylandTouchscreen* device = static_cast<WaylandTouchscreen*>(data);
+  if (device->pending_updates_.empty())
+    return;
+
+  device->dispatcher_->TouchFrameNotify(device->pending_updates_);
+  device->pending_updates_.clear();
 }
 
 void WaylandTouchscreen::OnTouchCancel(void *data,
                                        struct wl_touch *wl_touch) {
   WaylandTouchscreen* device = static_cast<WaylandTouchscreen*>(data);
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
 
-  device->dispatcher_->TouchNotify(ui::ET_TOUCH_CANCELLED,
-                                   device->pointer_position_.x(),
-                                   device->pointer_position_.y(),
-                                   input->GetGrabButton(),
-                                   0);
+  // The compositor took over the touch sequence, what it sent for the
+  // current frame doesn't matter anymore.
+  device->pending_updates_.clear();
+  for (size_t i = 0; i < kMaxTouchPoints; ++i) {
+    TouchSlot& slot = device->slots_[i];
+    if (!slot.active)
+      continue;
+
+    device->QueueUpdate(ui::ET_TOUCH_CANCELLED,
+                        slot.position.x(),
+                        slot.position.y(),
+                        slot.touch_id,
+                        0);
+    device->ReleaseSlot(&slot);
+  }
+
+  if (device->pending_updates_.empty())
+    return;
+
+  device->dispatcher_->TouchFrameNotify(device->pending_updates_);
+  device->pending_updates_.clear();
+}
+
+gfx::Vector2dF WaylandTouchscreen::GetVelocity(int32_t id) const {
+  for (size_t i = 0; i < kMaxTouchPoints; ++i) {
+    if (slots_[i].active && slots_[i].id == id)
+      return slots_[i].velocity;
+  }
+
+  return gfx::Vector2dF();
+}
+
+WaylandTouchscreen::TouchSlot* WaylandTouchscreen::FindSlot(int32_t id) {
+  for (size_t i = 0; i < kMaxTouchPoints; ++i) {
+    if (slots_[i].active && slots_[i].id == id)
+      return &slots_[i];
+  }
+
+  return NULL;
+}
+
+WaylandTouchscreen::TouchSlot* WaylandTouchscreen::AllocateSlot(int32_t id) {
+  TouchSlot* free_slot = NULL;
+  for (size_t i = 0; i < kMaxTouchPoints; ++i) {
+    // A down for a point that is already down means we missed its up.
+    if (slots_[i].active && slots_[i].id == id)
+      return &slots_[i];
+    if (!slots_[i].active && !free_slot)
+      free_slot = &slots_[i];
+  }
+
+  if (!free_slot)
+    return NULL;
+
+  // Touchscreens of other seats report the same ids, pick one which none of
+  // their points uses.
+  for (size_t i = 0; i < kMaxTouchPoints; ++i) {
+    if (touch_ids_in_use_ & (1u << i))
+      continue;
+
+    touch_ids_in_use_ |= 1u << i;
+    free_slot->active = true;
+    free_slot->id = id;
+    free_slot->touch_id = i;
+    return free_slot;
+  }
+
+  return NULL;
+}
+
+void WaylandTouchscreen::ReleaseSlot(TouchSlot* slot) {
+  DCHECK(slot->active);
+  touch_ids_in_use_ &= ~(1u << slot->touch_id);
+  slot->active = false;
+}
+
+void WaylandTouchscreen::QueueUpdate(ui::EventType type,
+                                     float x,
+                                     float y,
+                                     int32_t touch_id,
+                                     uint32_t time) {
+  if (type == ui::ET_TOUCH_MOVED) {
+    // Only the latest update of the point can absorb the motion, it may have
+    // been released and pressed again within the frame.
+    for (std::vector<ui::TouchUpdate>::reverse_iterator it =
+             pending_updates_.rbegin();
+         it != pending_updates_.rend(); ++it) {
+      if (it->touch_id != touch_id)
+        continue;
+
+      if (it->type == ui::ET_TOUCH_MOVED) {
+        it->x = x;
+        it->y = y;
+        it->time_stamp = time;
+        return;
+      }
+      break;
+    }
+  }
 
-  if (input->GetGrabWindowHandle() && input->GetGrabButton() != 0)
-    input->SetGrabWindowHandle(0, 0);
+  ui::TouchUpdate update;
+  update.type = type;
+  update.x = x;
+  update.y = y;
+  update.touch_id = touch_id;
+  update.time_stamp = time;
+  update.seat_id = seat_->GetId();
+  pending_updates_.push_back(update);
 }
 
 }  // namespace ozonewayland
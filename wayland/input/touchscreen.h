@@ -5,8 +5,12 @@
 #ifndef OZONE_WAYLAND_INPUT_TOUCHSCREEN_H_
 #define OZONE_WAYLAND_INPUT_TOUCHSCREEN_H_
 
+#include <vector>
+
+#include "ozone/ui/events/touch_update.h"
 #include "ozone/wayland/display.h"
-#include "ui/gfx/point.h"
+#include "ui/gfx/point_f.h"
+#include "ui/gfx/vector2d_f.h"
 
 namespace ui {
 class EventConverterOzoneWayland;
@@ -14,16 +18,43 @@ class EventConverterOzoneWayland;
 
 namespace ozonewayland {
 
+class WaylandInputDevice;
 class WaylandWindow;
 
+// Touch points are reported to the dispatcher a wl_touch frame at a time,
+// so that gesture recognition sees all fingers move together.
 class WaylandTouchscreen {
  public:
-  WaylandTouchscreen();
+  explicit WaylandTouchscreen(WaylandInputDevice* seat);
   ~WaylandTouchscreen();
 
   void OnSeatCapabilities(wl_seat *seat, uint32_t caps);
 
+  // Returns the velocity of touch point |id| in pixels per millisecond, or
+  // zero if the point isn't down.
+  gfx::Vector2dF GetVelocity(int32_t id) const;
+
  private:
+  // Touch points down at the same time, on all touchscreens together. Points
+  // beyond are ignored.
+  static const size_t kMaxTouchPoints = 10;
+
+  struct TouchSlot {
+    TouchSlot();
+
+    bool active;
+    int32_t id;
+    // Id the point is reported with, which the compositor's |id| may not be
+    // when several seats have touchscreens.
+    int32_t touch_id;
+    gfx::PointF position;
+    // Window the point went down on, which gets all its events.
+    unsigned window_handle;
+    uint32_t start_time;
+    uint32_t last_time;
+    gfx::Vector2dF velocity;
+  };
+
   static void OnTouchDown(
       void *data,
       struct wl_touch *wl_touch,
@@ -57,8 +88,27 @@ class WaylandTouchscreen {
       void *data,
       struct wl_touch *wl_touch);
 
+  TouchSlot* FindSlot(int32_t id);
+  TouchSlot* AllocateSlot(int32_t id);
+  void ReleaseSlot(TouchSlot* slot);
+
+  // Adds an update to the current frame. Motion of a point that already
+  // moved in this frame replaces the earlier motion.
+  void QueueUpdate(ui::EventType type,
+                   float x,
+                   float y,
+                   int32_t touch_id,
+                   uint32_t time);
+
+  // Touch ids in use by the points down on any touchscreen, one bit per id.
+  // Only accessed on the thread dispatching Wayland events.
+  static uint32_t touch_ids_in_use_;
+
+  WaylandInputDevice* seat_;
   ui::EventConverterOzoneWayland* dispatcher_;
-  gfx::Point pointer_position_;
+  TouchSlot slots_[kMaxTouchPoints];
+  // Updates received since the last wl_touch frame.
+  std::vector<ui::TouchUpdate> pending_updates_;
 
   DISALLOW_COPY_AND_ASSIGN(WaylandTouchscreen);
 };
@@ -8,6 +8,7 @@
 
 #include "ozone/ui/events/event_factory_ozone_wayland.h"
 #include "ozone/ui/events/keyboard_codes_ozone.h"
+#include "ozone/ui/events/resolved_key_event.h"
 #include "ozone/wayland/display.h"
 #include "ozone/wayland/input/keyboard.h"
 #include "ozone/wayland/input/keyboard_engine_xkb.h"
@@ -127,26 +128,32 @@ void WaylandTextInput::OnKeysym(void* data,
   ui::EventConverterOzoneWayland* dispatcher =
           ui::EventFactoryOzoneWayland::GetInstance()->EventConverter();
 
+  unsigned keysym;
   switch (key) {
     case XKB_KEY_KP_Enter:
     case XKB_KEY_Return:
     case XKB_KEY_ISO_Enter:
-      dispatcher->KeyNotify(type, ui::OZONEACTIONKEY_RETURN, modifiers);
+      keysym = ui::OZONEACTIONKEY_RETURN;
       break;
     case XKB_KEY_BackSpace:  // FIXME: Back space is not handled.
-      dispatcher->KeyNotify(type, ui::OZONEACTIONKEY_BACK, modifiers);
+      keysym = ui::OZONEACTIONKEY_BACK;
       break;
     case XKB_KEY_Left:
     case XKB_KEY_KP_Left:
-      dispatcher->KeyNotify(type, ui::OZONEACTIONKEY_LEFT, modifiers);
+      keysym = ui::OZONEACTIONKEY_LEFT;
       break;
     case XKB_KEY_Right:
     case XKB_KEY_KP_Right:
-      dispatcher->KeyNotify(type, ui::OZONEACTIONKEY_RIGHT, modifiers);
+      keysym = ui::OZONEACTIONKEY_RIGHT;
       break;
     default:
-      break;
+      return;
   }
+
+  ui::ResolvedKeyEvent event =
+      ui::ResolvedKeyEvent::FromKeysym(type, keysym, modifiers, time);
+  event.seat_id = textInuput->getInputDevice()->GetId();
+  dispatcher->KeyNotify(event);
 }
 
 void WaylandTextInput::OnEnter(void* data,
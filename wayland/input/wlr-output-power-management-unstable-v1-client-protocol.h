@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2019 Purism SPC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef WLR_OUTPUT_POWER_MANAGEMENT_UNSTABLE_V1_CLIENT_PROTOCOL_H
+#define WLR_OUTPUT_POWER_MANAGEMENT_UNSTABLE_V1_CLIENT_PROTOCOL_H
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "wayland-client.h"
+
+struct wl_client;
+struct wl_resource;
+
+struct wl_output;
+struct zwlr_output_power_manager_v1;
+struct zwlr_output_power_v1;
+
+extern const struct wl_interface zwlr_output_power_manager_v1_interface;
+extern const struct wl_interface zwlr_output_power_v1_interface;
+
+#define ZWLR_OUTPUT_POWER_MANAGER_V1_GET_OUTPUT_POWER	0
+#define ZWLR_OUTPUT_POWER_MANAGER_V1_DESTROY	1
+
+static inline void
+zwlr_output_power_manager_v1_set_user_data(struct zwlr_output_power_manager_v1 *zwlr_output_power_manager_v1, void *user_data)
+{
+	wl_proxy_set_user_data((struct wl_proxy *) zwlr_output_power_manager_v1, user_data);
+}
+
+static inline void *
+zwlr_output_power_manager_v1_get_user_data(struct zwlr_output_power_manager_v1 *zwlr_output_power_manager_v1)
+{
+	return wl_proxy_get_user_data((struct wl_proxy *) zwlr_output_power_manager_v1);
+}
+
+static inline struct zwlr_output_power_v1 *
+zwlr_output_power_manager_v1_get_output_power(struct zwlr_output_power_manager_v1 *zwlr_output_power_manager_v1, struct wl_output *output)
+{
+	struct wl_proxy *id;
+
+	id = wl_proxy_marshal_constructor((struct wl_proxy *) zwlr_output_power_manager_v1,
+			 ZWLR_OUTPUT_POWER_MANAGER_V1_GET_OUTPUT_POWER, &zwlr_output_power_v1_interface, NULL, output);
+
+	return (struct zwlr_output_power_v1 *) id;
+}
+
+static inline void
+zwlr_output_power_manager_v1_destroy(struct zwlr_output_power_manager_v1 *zwlr_output_power_manager_v1)
+{
+	wl_proxy_marshal((struct wl_proxy *) zwlr_output_power_manager_v1,
+			 ZWLR_OUTPUT_POWER_MANAGER_V1_DESTROY);
+
+	wl_proxy_destroy((struct wl_proxy *) zwlr_output_power_manager_v1);
+}
+
+#ifndef ZWLR_OUTPUT_POWER_V1_MODE_ENUM
+#define ZWLR_OUTPUT_POWER_V1_MODE_ENUM
+/**
+ * zwlr_output_power_v1_mode - power save modes
+ * @ZWLR_OUTPUT_POWER_V1_MODE_OFF: Output is turned off.
+ * @ZWLR_OUTPUT_POWER_V1_MODE_ON: Output is turned on, no power saving
+ */
+enum zwlr_output_power_v1_mode {
+	ZWLR_OUTPUT_POWER_V1_MODE_OFF = 0,
+	ZWLR_OUTPUT_POWER_V1_MODE_ON = 1,
+};
+#endif /* ZWLR_OUTPUT_POWER_V1_MODE_ENUM */
+
+#ifndef ZWLR_OUTPUT_POWER_V1_ERROR_ENUM
+#define ZWLR_OUTPUT_POWER_V1_ERROR_ENUM
+enum zwlr_output_power_v1_error {
+	ZWLR_OUTPUT_POWER_V1_ERROR_INVALID_MODE = 1,
+};
+#endif /* ZWLR_OUTPUT_POWER_V1_ERROR_ENUM */
+
+/**
+ * zwlr_output_power_v1 - adjust power management mode for an output
+ * @mode: report a power management mode change
+ * @failed: object no longer valid
+ *
+ * This object offers requests to set the power management mode of an
+ * output.
+ */
+struct zwlr_output_power_v1_listener {
+	/**
+	 * mode - report a power management mode change
+	 * @mode: the output's new power management mode
+	 *
+	 * Report the power management mode change of an output.
+	 *
+	 * The mode event is sent after an output changed its power
+	 * management mode. The reason can be a client using set_mode or
+	 * the compositor deciding to change an output's mode. This event
+	 * is also sent immediately when the object is created so the
+	 * client is informed about the current power management mode.
+	 */
+	void (*mode)(void *data,
+		     struct zwlr_output_power_v1 *zwlr_output_power_v1,
+		     uint32_t mode);
+	/**
+	 * failed - object no longer valid
+	 *
+	 * This event indicates that the output power management mode
+	 * control is no longer valid. This can happen for a number of
+	 * reasons, including: - The output doesn't support power
+	 * management - Another client already has exclusive power
+	 * management mode control for this output - The output
+	 * disappeared
+	 *
+	 * Upon receiving this event, the client should destroy this
+	 * object.
+	 */
+	void (*failed)(void *data,
+		       struct zwlr_output_power_v1 *zwlr_output_power_v1);
+};
+
+static inline int
+zwlr_output_power_v1_add_listener(struct zwlr_output_power_v1 *zwlr_output_power_v1,
+				  const struct zwlr_output_power_v1_listener *listener, void *data)
+{
+	return wl_proxy_add_listener((struct wl_proxy *) zwlr_output_power_v1,
+				     (void (**)(void)) listener, data);
+}
+
+#define ZWLR_OUTPUT_POWER_V1_SET_MODE	0
+#define ZWLR_OUTPUT_POWER_V1_DESTROY	1
+
+static inline void
+zwlr_output_power_v1_set_user_data(struct zwlr_output_power_v1 *zwlr_output_power_v1, void *user_data)
+{
+	wl_proxy_set_user_data((struct wl_proxy *) zwlr_output_power_v1, user_data);
+}
+
+static inline void *
+zwlr_output_power_v1_get_user_data(struct zwlr_output_power_v1 *zwlr_output_power_v1)
+{
+	return wl_proxy_get_user_data((struct wl_proxy *) zwlr_output_power_v1);
+}
+
+static inline void
+zwlr_output_power_v1_set_mode(struct zwlr_output_power_v1 *zwlr_output_power_v1, uint32_t mode)
+{
+	wl_proxy_marshal((struct wl_proxy *) zwlr_output_power_v1,
+			 ZWLR_OUTPUT_POWER_V1_SET_MODE, mode);
+}
+
+static inline void
+zwlr_output_power_v1_destroy(struct zwlr_output_power_v1 *zwlr_output_power_v1)
+{
+	wl_proxy_marshal((struct wl_proxy *) zwlr_output_power_v1,
+			 ZWLR_OUTPUT_POWER_V1_DESTROY);
+
+	wl_proxy_destroy((struct wl_proxy *) zwlr_output_power_v1);
+}
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif
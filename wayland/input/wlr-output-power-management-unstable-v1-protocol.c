@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2019 Purism SPC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "wayland-util.h"
+
+extern const struct wl_interface wl_output_interface;
+extern const struct wl_interface zwlr_output_power_v1_interface;
+
+static const struct wl_interface *types[] = {
+	NULL,
+	&zwlr_output_power_v1_interface,
+	&wl_output_interface,
+};
+
+static const struct wl_message zwlr_output_power_manager_v1_requests[] = {
+	{ "get_output_power", "no", types + 1 },
+	{ "destroy", "", types + 0 },
+};
+
+WL_EXPORT const struct wl_interface zwlr_output_power_manager_v1_interface = {
+	"zwlr_output_power_manager_v1", 1,
+	2, zwlr_output_power_manager_v1_requests,
+	0, NULL,
+};
+
+static const struct wl_message zwlr_output_power_v1_requests[] = {
+	{ "set_mode", "u", types + 0 },
+	{ "destroy", "", types + 0 },
+};
+
+static const struct wl_message zwlr_output_power_v1_events[] = {
+	{ "mode", "u", types + 0 },
+	{ "failed", "", types + 0 },
+};
+
+WL_EXPORT const struct wl_interface zwlr_output_power_v1_interface = {
+	"zwlr_output_power_v1", 1,
+	2, zwlr_output_power_v1_requests,
+	2, zwlr_output_power_v1_events,
+};
+
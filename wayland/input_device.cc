@@ -5,6 +5,8 @@
 
 #include "ozone/wayland/input_device.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "ozone/wayland/display.h"
 #include "ozone/wayland/input/cursor.h"
@@ -19,6 +21,16 @@
 
 namespace ozonewayland {
 
+// Version 4 brings wl_keyboard.repeat_info and version 5 the wl_pointer
+// frame and axis events, which older protocol headers don't know about.
+#if defined(WL_POINTER_FRAME_SINCE_VERSION)
+const uint32_t kMaxSeatVersion = WL_POINTER_FRAME_SINCE_VERSION;
+#elif defined(WL_KEYBOARD_REPEAT_INFO_SINCE_VERSION)
+const uint32_t kMaxSeatVersion = WL_KEYBOARD_REPEAT_INFO_SINCE_VERSION;
+#else
+const uint32_t kMaxSeatVersion = 1;
+#endif
+
 const int kCursorNull = 0;
 const int kCursorPointer = 1;
 const int kCursorCross = 2;
@@ -135,22 +147,28 @@ WaylandCursor::CursorType CursorShapeFromNative(unsigned cursor_type) {
 }
 
 WaylandInputDevice::WaylandInputDevice(WaylandDisplay* display,
-                                       uint32_t id)
-    : focused_window_handle_(0),
+                                       uint32_t id,
+                                       uint32_t version)
+    : id_(id),
+      focused_window_handle_(0),
       grab_window_handle_(0),
       grab_button_(0),
+      serial_(0),
       input_seat_(NULL),
       input_keyboard_(NULL),
       input_pointer_(NULL),
       input_touch_(NULL),
       text_input_(NULL) {
-  ui::IMEStateChangeHandler::SetInstance(this);
   static const struct wl_seat_listener kInputSeatListener = {
     WaylandInputDevice::OnSeatCapabilities,
+    WaylandInputDevice::OnSeatName,
   };
 
   input_seat_ = static_cast<wl_seat*>(
-      wl_registry_bind(display->registry(), id, &wl_seat_interface, 1));
+      wl_registry_bind(display->registry(),
+                       id,
+                       &wl_seat_interface,
+                       std::min(version, kMaxSeatVersion)));
   DCHECK(input_seat_);
   wl_seat_add_listener(input_seat_, &kInputSeatListener, this);
   wl_seat_set_user_data(input_seat_, this);
@@ -172,7 +190,7 @@ void WaylandInputDevice::OnSeatCapabilities(void *data,
                                             uint32_t caps) {
   WaylandInputDevice* device = static_cast<WaylandInputDevice*>(data);
   if ((caps & WL_SEAT_CAPABILITY_KEYBOARD) && !device->input_keyboard_) {
-    device->input_keyboard_ = new WaylandKeyboard();
+    device->input_keyboard_ = new WaylandKeyboard(device);
     device->input_keyboard_->OnSeatCapabilities(seat, caps);
   } else if (!(caps & WL_SEAT_CAPABILITY_KEYBOARD) && device->input_keyboard_) {
     device->input_keyboard_->OnSeatCapabilities(seat, caps);
@@ -181,7 +199,7 @@ void WaylandInputDevice::OnSeatCapabilities(void *data,
   }
 
   if ((caps & WL_SEAT_CAPABILITY_POINTER) && !device->input_pointer_) {
-    device->input_pointer_ = new WaylandPointer();
+    device->input_pointer_ = new WaylandPointer(device);
     device->input_pointer_->OnSeatCapabilities(seat, caps);
   } else if (!(caps & WL_SEAT_CAPABILITY_POINTER) && device->input_pointer_) {
     device->input_pointer_->OnSeatCapabilities(seat, caps);
@@ -190,7 +208,7 @@ void WaylandInputDevice::OnSeatCapabilities(void *data,
   }
 
   if ((caps & WL_SEAT_CAPABILITY_TOUCH) && !device->input_touch_) {
-    device->input_touch_ = new WaylandTouchscreen();
+    device->input_touch_ = new WaylandTouchscreen(device);
     device->input_touch_->OnSeatCapabilities(seat, caps);
   } else if (!(caps & WL_SEAT_CAPABILITY_TOUCH) && device->input_touch_) {
     device->input_touch_->OnSeatCapabilities(seat, caps);
@@ -199,6 +217,11 @@ void WaylandInputDevice::OnSeatCapabilities(void *data,
   }
 }
 
+void WaylandInputDevice::OnSeatName(void* data,
+                                    wl_seat* seat,
+                                    const char* name) {
+}
+
 void WaylandInputDevice::SetFocusWindowHandle(unsigned windowhandle) {
   focused_window_handle_ = windowhandle;
   WaylandWindow* window = NULL;
@@ -207,8 +230,34 @@ void WaylandInputDevice::SetFocusWindowHandle(unsigned windowhandle) {
   text_input_->SetActiveWindow(window);
 }
 
+unsigned WaylandInputDevice::GetGrabWindowHandle() const {
+  base::AutoLock auto_lock(lock_);
+  return grab_window_handle_;
+}
+
+uint32_t WaylandInputDevice::GetGrabButton() const {
+  base::AutoLock auto_lock(lock_);
+  return grab_button_;
+}
+
+uint32_t WaylandInputDevice::GetSerial() const {
+  base::AutoLock auto_lock(lock_);
+  return serial_;
+}
+
+void WaylandInputDevice::SetSerial(uint32_t serial) {
+  {
+    base::AutoLock auto_lock(lock_);
+    serial_ = serial;
+  }
+  WaylandDisplay* display = WaylandDisplay::GetInstance();
+  display->SetSerial(serial);
+  display->SetActiveInput(this);
+}
+
 void WaylandInputDevice::SetGrabWindowHandle(unsigned windowhandle,
                                              uint32_t button) {
+  base::AutoLock auto_lock(lock_);
   grab_window_handle_ = windowhandle;
   grab_button_ = button;
 }
@@ -219,7 +268,30 @@ void WaylandInputDevice::SetCursorType(int cursor_type) {
     return;
   }
   input_pointer_->Cursor()->Update(CursorShapeFromNative(cursor_type),
-                                   WaylandDisplay::GetInstance()->GetSerial());
+                                   GetSerial());
+}
+
+void WaylandInputDevice::SetCursorBitmap(uint32 hash,
+                                         const SkBitmap& bitmap,
+                                         const gfx::Point& hotspot) {
+  if (!input_pointer_) {
+    LOG(WARNING) << "Tried to change cursor without input configured";
+    return;
+  }
+  input_pointer_->Cursor()->UpdateBitmap(hash, bitmap, hotspot, GetSerial());
+}
+
+bool WaylandInputDevice::SetCachedCursorBitmap(uint32 hash,
+                                               const gfx::Size& size,
+                                               const gfx::Point& hotspot) {
+  if (!input_pointer_) {
+    LOG(WARNING) << "Tried to change cursor without input configured";
+    return true;
+  }
+  return input_pointer_->Cursor()->UpdateCachedBitmap(hash,
+                                                      size,
+                                                      hotspot,
+                                                      GetSerial());
 }
 
 void WaylandInputDevice::ResetIme() {
@@ -7,7 +7,14 @@
 
 #include <wayland-client.h>
 #include "base/basictypes.h"
-#include "ozone/ui/events/ime_state_change_handler.h"
+#include "base/synchronization/lock.h"
+#include "ui/gfx/rect.h"
+
+class SkBitmap;
+
+namespace gfx {
+class Point;
+}
 
 namespace ozonewayland {
 
@@ -17,35 +24,62 @@ class WaylandDisplay;
 class WaylandTouchscreen;
 class WaylandTextInput;
 
-class WaylandInputDevice : public ui::IMEStateChangeHandler {
+// A wl_seat, with its own pointer, keyboard and touchscreen, and its own
+// focus and grab state. A display can have several seats, e.g. a touchscreen
+// and a separate keypad, which don't affect each other.
+class WaylandInputDevice {
  public:
-  WaylandInputDevice(WaylandDisplay* display, uint32_t id);
+  WaylandInputDevice(WaylandDisplay* display, uint32_t id, uint32_t version);
   virtual ~WaylandInputDevice();
 
+  // Identifies the seat in the events it sends. This is the name of its
+  // wl_seat global.
+  uint32_t GetId() const { return id_; }
   wl_seat* GetInputSeat() const { return input_seat_; }
   WaylandKeyboard* GetKeyBoard() const { return input_keyboard_; }
   WaylandPointer* GetPointer() const { return input_pointer_; }
   unsigned GetFocusWindowHandle() const { return focused_window_handle_; }
-  unsigned GetGrabWindowHandle() const { return grab_window_handle_; }
-  uint32_t GetGrabButton() const { return grab_button_; }
+  unsigned GetGrabWindowHandle() const;
+  uint32_t GetGrabButton() const;
+  // Serial of the latest input event of the seat, which requests such as
+  // popup grabs and cursor changes need.
+  uint32_t GetSerial() const;
+  // Records the serial of an input event, which makes this the active seat
+  // of the display.
+  void SetSerial(uint32_t serial);
   void SetFocusWindowHandle(unsigned windowhandle);
   void SetGrabWindowHandle(unsigned windowhandle, uint32_t button);
   void SetCursorType(int cursor_type);
+  void SetCursorBitmap(uint32 hash,
+                       const SkBitmap& bitmap,
+                       const gfx::Point& hotspot);
+  // Returns false if the image isn't cached.
+  bool SetCachedCursorBitmap(uint32 hash,
+                             const gfx::Size& size,
+                             const gfx::Point& hotspot);
 
-  virtual void ResetIme() OVERRIDE;
-  virtual void ImeCaretBoundsChanged(gfx::Rect rect) OVERRIDE;
-  virtual void ShowInputPanel() OVERRIDE;
-  virtual void HideInputPanel() OVERRIDE;
+  // Input method requests, which WaylandDisplay forwards to the seat whose
+  // keyboard has focus.
+  void ResetIme();
+  void ImeCaretBoundsChanged(gfx::Rect rect);
+  void ShowInputPanel();
+  void HideInputPanel();
 
  private:
   static void OnSeatCapabilities(void *data,
                                  wl_seat *seat,
                                  uint32_t caps);
+  static void OnSeatName(void* data, wl_seat* seat, const char* name);
 
+  uint32_t id_;
   // Keeps track of current focused window.
   unsigned focused_window_handle_;
+  // Protects the grab state and |serial_|, which are updated on the poll
+  // thread and used by requests made on the GPU thread.
+  mutable base::Lock lock_;
   unsigned grab_window_handle_;
   uint32_t grab_button_;
+  uint32_t serial_;
   wl_seat* input_seat_;
   WaylandKeyboard* input_keyboard_;
   WaylandPointer* input_pointer_;
@@ -9,11 +9,14 @@
 
 #include "ozone/ui/events/event_factory_ozone_wayland.h"
 #include "ozone/wayland/display.h"
+#include "ozone/wayland/input/wlr-output-power-management-unstable-v1-client-protocol.h"
 
 namespace ozonewayland {
 
 WaylandScreen::WaylandScreen(wl_registry* registry, uint32_t id)
     : output_(NULL),
+      output_power_(NULL),
+      powered_on_(true),
       refresh_(0),
       rect_(0, 0, 0, 0) {
   static const wl_output_listener kOutputListener = {
@@ -28,9 +31,27 @@ WaylandScreen::WaylandScreen(wl_registry* registry, uint32_t id)
 }
 
 WaylandScreen::~WaylandScreen() {
+  if (output_power_)
+    zwlr_output_power_v1_destroy(output_power_);
   wl_output_destroy(output_);
 }
 
+void WaylandScreen::BindOutputPower(zwlr_output_power_manager_v1* manager) {
+  static const zwlr_output_power_v1_listener kOutputPowerListener = {
+    WaylandScreen::OutputPowerHandleMode,
+    WaylandScreen::OutputPowerHandleFailed,
+  };
+
+  if (output_power_)
+    return;
+
+  // The current mode is sent right away.
+  output_power_ = zwlr_output_power_manager_v1_get_output_power(manager,
+                                                                output_);
+  zwlr_output_power_v1_add_listener(output_power_, &kOutputPowerListener,
+                                    this);
+}
+
 // static
 void WaylandScreen::OutputHandleGeometry(void *data,
                                          wl_output *output,
@@ -67,4 +88,30 @@ void WaylandScreen::OutputHandleMode(void* data,
   }
 }
 
+// static
+void WaylandScreen::OutputPowerHandleMode(void* data,
+                                          zwlr_output_power_v1* output_power,
+                                          uint32_t mode) {
+  WaylandScreen* screen = static_cast<WaylandScreen*>(data);
+  WaylandDisplay* display = WaylandDisplay::GetInstance();
+  if (display) {
+    display->OnOutputPowerChanged(screen,
+                                  mode != ZWLR_OUTPUT_POWER_V1_MODE_OFF);
+  }
+}
+
+// static
+void WaylandScreen::OutputPowerHandleFailed(
+    void* data,
+    zwlr_output_power_v1* output_power) {
+  // Another client controls the power of the output, or it is going away.
+  // Either way no more modes will be reported, assume it is on.
+  WaylandScreen* screen = static_cast<WaylandScreen*>(data);
+  zwlr_output_power_v1_destroy(screen->output_power_);
+  screen->output_power_ = NULL;
+  WaylandDisplay* display = WaylandDisplay::GetInstance();
+  if (display)
+    display->OnOutputPowerChanged(screen, true);
+}
+
 }  // namespace ozonewayland
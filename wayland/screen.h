@@ -14,6 +14,8 @@
 
 struct wl_output;
 struct wl_registry;
+struct zwlr_output_power_manager_v1;
+struct zwlr_output_power_v1;
 
 namespace ozonewayland {
 
@@ -29,6 +31,19 @@ class WaylandScreen {
   // Returns the active allocation of the screen.
   gfx::Rect Geometry() const { return rect_; }
 
+  wl_output* GetOutput() const { return output_; }
+
+  // Returns whether the output is showing anything. Outputs are assumed to be
+  // on unless the compositor reports their power mode. Only used on the GPU
+  // thread, which WaylandDisplay hands power mode changes to.
+  bool IsPoweredOn() const { return powered_on_; }
+  void SetPoweredOn(bool powered_on) { powered_on_ = powered_on; }
+  // Starts listening to power mode changes of the output. This makes us the
+  // client controlling the power of the output, and the compositor refuses
+  // that to anyone else, so WaylandDisplay only does it when asked to with
+  // OZONE_WAYLAND_WATCH_OUTPUT_POWER.
+  void BindOutputPower(zwlr_output_power_manager_v1* manager);
+
  private:
   // Callback functions that allows the display to initialize the screen's
   // position and available modes.
@@ -50,8 +65,16 @@ class WaylandScreen {
                                int32_t height,
                                int32_t refresh);
 
+  static void OutputPowerHandleMode(void* data,
+                                    zwlr_output_power_v1* output_power,
+                                    uint32_t mode);
+  static void OutputPowerHandleFailed(void* data,
+                                      zwlr_output_power_v1* output_power);
+
   // The Wayland output this object wraps
   wl_output* output_;
+  zwlr_output_power_v1* output_power_;
+  bool powered_on_;
 
   // Rect and Refresh rate of active mode.
   int32_t refresh_;
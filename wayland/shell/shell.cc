@@ -6,6 +6,7 @@
 
 #include "base/logging.h"
 #include "ozone/wayland/display.h"
+#include "ozone/wayland/shell/subsurface.h"
 #include "ozone/wayland/shell/wl_shell_surface.h"
 #if defined(ENABLE_XDG_SHELL)
 #include "ozone/wayland/shell/xdg-shell-client-protocol.h"
@@ -22,7 +23,8 @@ WaylandShell::WaylandShell()
 #if defined(WEBOS)
       webos_shell_(NULL),
 #endif
-      xdg_shell_(NULL) {
+      xdg_shell_(NULL),
+      subcompositor_(NULL) {
 }
 
 WaylandShell::~WaylandShell() {
@@ -36,6 +38,8 @@ WaylandShell::~WaylandShell() {
   if (xdg_shell_)
     xdg_shell_destroy(xdg_shell_);
 #endif
+  if (subcompositor_)
+    wl_subcompositor_destroy(subcompositor_);
 }
 
 WaylandShellSurface* WaylandShell::CreateShellSurface(WaylandWindow* window) {
@@ -62,6 +66,16 @@ WaylandShellSurface* WaylandShell::CreateShellSurface(WaylandWindow* window) {
   return surface;
 }
 
+WaylandShellSurface* WaylandShell::CreateSubsurface(WaylandWindow* window) {
+  if (!subcompositor_)
+    return NULL;
+
+  WaylandShellSurface* surface = new WaylandSubsurface();
+  surface->InitializeShellSurface(window);
+  wl_surface_set_user_data(surface->GetWLSurface(), window);
+  return surface;
+}
+
 void WaylandShell::Initialize(struct wl_registry *registry,
                               uint32_t name,
                               const char *interface,
@@ -70,6 +84,11 @@ void WaylandShell::Initialize(struct wl_registry *registry,
     DCHECK(!shell_);
     shell_ = static_cast<wl_shell*>(
         wl_registry_bind(registry, name, &wl_shell_interface, 1));
+  } else if ((strcmp(interface, "wl_subcompositor") == 0) &&
+             getenv("OZONE_WAYLAND_USE_SUBSURFACES")) {
+    DCHECK(!subcompositor_);
+    subcompositor_ = static_cast<wl_subcompositor*>(
+        wl_registry_bind(registry, name, &wl_subcompositor_interface, 1));
 #if defined(WEBOS)
   } else if (strcmp(interface, "wl_webos_shell") == 0) {
     DCHECK(!webos_shell_);
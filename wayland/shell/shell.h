@@ -26,6 +26,10 @@ class WaylandShell {
   // wl_shell, xdg_shell or any shell which supports wayland protocol.
   // Ownership is passed to the caller.
   WaylandShellSurface* CreateShellSurface(WaylandWindow* parent);
+  // Creates a surface realizing |window| as a subsurface of its parent, if
+  // enabled with OZONE_WAYLAND_USE_SUBSURFACES and supported by the
+  // compositor. Returns NULL otherwise. Ownership is passed to the caller.
+  WaylandShellSurface* CreateSubsurface(WaylandWindow* window);
   void Initialize(struct wl_registry *registry,
                   uint32_t name,
                   const char *interface,
@@ -36,6 +40,7 @@ class WaylandShell {
   wl_webos_shell* GetWebosWLShell() const { return webos_shell_; }
 #endif
   xdg_shell* GetXDGShell() const { return xdg_shell_; }
+  wl_subcompositor* GetSubcompositor() const { return subcompositor_; }
 
  private:
 #if defined(ENABLE_XDG_SHELL)
@@ -48,6 +53,7 @@ class WaylandShell {
   wl_webos_shell* webos_shell_;
 #endif
   xdg_shell* xdg_shell_;
+  wl_subcompositor* subcompositor_;
   DISALLOW_COPY_AND_ASSIGN(WaylandShell);
 };
 
@@ -10,8 +10,24 @@
 
 namespace ozonewayland {
 
+namespace {
+
+// A size handed to the browser which doesn't lead to a new frame, e.g. because
+// the window is minimized or its output is blanked, stops holding back the
+// newer ones after this long.
+const int kConfigureTimeoutMs = 200;
+
+}  // namespace
+
 WaylandShellSurface::WaylandShellSurface()
-    : surface_(NULL) {
+    : surface_(NULL),
+      width_(0),
+      height_(0),
+      configure_in_flight_(false),
+      has_pending_configure_(false),
+      pending_width_(0),
+      pending_height_(0),
+      configure_window_(NULL) {
   WaylandDisplay* display = WaylandDisplay::GetInstance();
   surface_ = wl_compositor_create_surface(display->GetCompositor());
 }
@@ -26,27 +42,157 @@ struct wl_surface* WaylandShellSurface::GetWLSurface() const {
     return surface_;
 }
 
+bool WaylandShellSurface::IsSubsurface() const {
+  return false;
+}
+
 void WaylandShellSurface::FlushDisplay() const {
   WaylandDisplay* display = WaylandDisplay::GetInstance();
   DCHECK(display);
   display->FlushDisplay();
 }
 
+void WaylandShellSurface::OnFrameSwapped(WaylandWindow* window) {
+  ConfigureHandled(window);
+}
+
+void WaylandShellSurface::OnResized(WaylandWindow* window,
+                                    unsigned width,
+                                    unsigned height) {
+  {
+    base::AutoLock auto_lock(configure_lock_);
+    width_ = width;
+    height_ = height;
+  }
+
+  ConfigureHandled(window);
+}
+
+void WaylandShellSurface::ConfigureHandled(WaylandWindow* window) {
+  unsigned width;
+  unsigned height;
+  {
+    base::AutoLock auto_lock(configure_lock_);
+    if (!has_pending_configure_) {
+      configure_in_flight_ = false;
+      return;
+    }
+
+    width = pending_width_;
+    height = pending_height_;
+    has_pending_configure_ = false;
+    StartConfigure(width, height);
+  }
+
+  DispatchWindowResized(window, width, height);
+}
+
+void WaylandShellSurface::FlushPendingConfigure(WaylandWindow* window) {
+  unsigned width = 0;
+  unsigned height = 0;
+  base::TimeDelta remaining;
+  {
+    base::AutoLock auto_lock(configure_lock_);
+    if (!has_pending_configure_)
+      return;
+
+    remaining = configure_time_ +
+        base::TimeDelta::FromMilliseconds(kConfigureTimeoutMs) -
+        base::TimeTicks::Now();
+    if (remaining <= base::TimeDelta()) {
+      width = pending_width_;
+      height = pending_height_;
+      has_pending_configure_ = false;
+      StartConfigure(width, height);
+    }
+  }
+
+  if (remaining > base::TimeDelta()) {
+    configure_window_ = window;
+    configure_timer_.Start(FROM_HERE,
+                           remaining,
+                           this,
+                           &WaylandShellSurface::OnConfigureTimeout);
+    return;
+  }
+
+  DispatchWindowResized(window, width, height);
+}
+
+void WaylandShellSurface::OnConfigureTimeout() {
+  FlushPendingConfigure(configure_window_);
+}
+
+void WaylandShellSurface::StartConfigure(unsigned width, unsigned height) {
+  configure_lock_.AssertAcquired();
+  // The browser has nothing to redraw for the size the window already has,
+  // so there is no swap to wait for.
+  configure_in_flight_ = width != width_ || height != height_;
+  if (configure_in_flight_)
+    configure_time_ = base::TimeTicks::Now();
+}
+
 void WaylandShellSurface::PopupDone() {
-  WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
   ui::EventConverterOzoneWayland* dispatcher =
       ui::EventFactoryOzoneWayland::GetInstance()->EventConverter();
 
-  if (!input->GetGrabWindowHandle())
+  // The popup grab belongs to whichever seat opened the popup.
+  const std::list<WaylandInputDevice*>& inputs =
+      WaylandDisplay::GetInstance()->GetInputList();
+  for (std::list<WaylandInputDevice*>::const_iterator i = inputs.begin();
+       i != inputs.end(); ++i) {
+    WaylandInputDevice* input = *i;
+    if (!input->GetGrabWindowHandle())
+      continue;
+    dispatcher->CloseWidget(input->GetGrabWindowHandle());
+    input->SetGrabWindowHandle(0, 0);
+  }
+}
+
+void WaylandShellSurface::DismissSubsurfacePopup(unsigned grab_window) {
+  WaylandWindow* window = WaylandDisplay::GetInstance()->GetWindow(grab_window);
+  if (!window || !window->ShellSurface() ||
+      !window->ShellSurface()->IsSubsurface()) {
     return;
-  dispatcher->CloseWidget(input->GetGrabWindowHandle());
-  input->SetGrabWindowHandle(0, 0);
+  }
+
+  PopupDone();
 }
 
 void WaylandShellSurface::WindowResized(void* data,
                                  unsigned width,
                                  unsigned height) {
   WaylandWindow *window = static_cast<WaylandWindow*>(data);
+  WaylandShellSurface* shell_surface = window->ShellSurface();
+  DCHECK(shell_surface);
+  {
+    base::AutoLock auto_lock(shell_surface->configure_lock_);
+    if (shell_surface->configure_in_flight_ &&
+        base::TimeTicks::Now() - shell_surface->configure_time_ <
+            base::TimeDelta::FromMilliseconds(kConfigureTimeoutMs)) {
+      bool timer_armed = shell_surface->has_pending_configure_;
+      shell_surface->has_pending_configure_ = true;
+      shell_surface->pending_width_ = width;
+      shell_surface->pending_height_ = height;
+      // The timer runs on the GPU thread, where the window may be gone by the
+      // time it gets there.
+      if (!timer_armed) {
+        WaylandDisplay::GetInstance()->OnWindowConfigureDeferred(
+            window->Handle());
+      }
+      return;
+    }
+
+    shell_surface->has_pending_configure_ = false;
+    shell_surface->StartConfigure(width, height);
+  }
+
+  DispatchWindowResized(window, width, height);
+}
+
+void WaylandShellSurface::DispatchWindowResized(WaylandWindow* window,
+                                                unsigned width,
+                                                unsigned height) {
   ui::EventConverterOzoneWayland* dispatcher =
       ui::EventFactoryOzoneWayland::GetInstance()->EventConverter();
   dispatcher->WindowResized(window->Handle(), width, height);
@@ -8,6 +8,9 @@
 #include <wayland-client.h>
 
 #include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "ozone/wayland/window.h"
 
 namespace ozonewayland {
@@ -31,16 +34,62 @@ class WaylandShellSurface {
   virtual void SetWindowTitle(const base::string16& title) = 0;
   virtual void Maximize() = 0;
   virtual void Minimize() = 0;
+  // Returns true if the window is realized as a subsurface of its parent
+  // rather than as a surface of the shell.
+  virtual bool IsSubsurface() const;
+
+  // Called on the GPU thread once a frame of the window has been swapped.
+  // Forwards the latest size suggested by the compositor since the last
+  // forwarded one, if any.
+  void OnFrameSwapped(WaylandWindow* window);
+  // Called on the GPU thread once the browser resized the window, which
+  // acknowledges the size handed to it even if no frame follows.
+  void OnResized(WaylandWindow* window, unsigned width, unsigned height);
+  // Called on the GPU thread once a size got held back. Forwards it when the
+  // size in flight times out, should neither a swap nor a resize come first.
+  void FlushPendingConfigure(WaylandWindow* window);
 
   // static functions.
   static void PopupDone();
+  // Dismisses the popup |grab_window| if it is realized as a subsurface. The
+  // compositor does this for shell popups, but subsurfaces get no popup grab.
+  static void DismissSubsurfacePopup(unsigned grab_window);
+  // Called from the configure handlers of the shells. Only one suggested size
+  // is handed to the browser per frame or resize, sizes which are replaced by
+  // newer ones in the meantime are dropped.
   static void WindowResized(void *data, unsigned width, unsigned height);
 
  protected:
   void FlushDisplay() const;
 
  private:
+  static void DispatchWindowResized(WaylandWindow* window,
+                                    unsigned width,
+                                    unsigned height);
+  void ConfigureHandled(WaylandWindow* window);
+  void OnConfigureTimeout();
+  // Marks a size about to be handed to the browser as in flight, unless the
+  // window already has it. Called with |configure_lock_| held.
+  void StartConfigure(unsigned width, unsigned height);
+
   struct wl_surface* surface_;
+
+  // Protects the configure state below, which is updated on the poll thread
+  // and consumed on the GPU thread.
+  base::Lock configure_lock_;
+  // Size of the window as last acknowledged by the browser.
+  unsigned width_;
+  unsigned height_;
+  // Set from the time a size is handed to the browser until a frame is
+  // swapped, the window is resized or kConfigureTimeoutMs passed.
+  bool configure_in_flight_;
+  base::TimeTicks configure_time_;
+  bool has_pending_configure_;
+  unsigned pending_width_;
+  unsigned pending_height_;
+  // GPU thread only.
+  base::OneShotTimer<WaylandShellSurface> configure_timer_;
+  WaylandWindow* configure_window_;
   DISALLOW_COPY_AND_ASSIGN(WaylandShellSurface);
 };
 
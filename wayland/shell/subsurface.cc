@@ -0,0 +1,68 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ozone/wayland/shell/subsurface.h"
+
+#include "base/logging.h"
+
+#include "ozone/wayland/display.h"
+#include "ozone/wayland/shell/shell.h"
+
+namespace ozonewayland {
+
+WaylandSubsurface::WaylandSubsurface()
+    : WaylandShellSurface(),
+      subsurface_(NULL) {
+}
+
+WaylandSubsurface::~WaylandSubsurface() {
+  if (subsurface_)
+    wl_subsurface_destroy(subsurface_);
+}
+
+void WaylandSubsurface::InitializeShellSurface(WaylandWindow* window) {
+  // The subsurface can only be created once the parent is known.
+}
+
+void WaylandSubsurface::UpdateShellSurface(WaylandWindow::ShellType type,
+                                           WaylandShellSurface* shell_parent,
+                                           unsigned x,
+                                           unsigned y) {
+  if (type != WaylandWindow::POPUP) {
+    NOTREACHED() << "Unsupported shell type: " << type;
+    return;
+  }
+
+  DCHECK(shell_parent);
+  wl_surface* parent_surface = shell_parent->GetWLSurface();
+  if (!subsurface_) {
+    WaylandShell* shell = WaylandDisplay::GetInstance()->GetShell();
+    DCHECK(shell->GetSubcompositor());
+    subsurface_ = wl_subcompositor_get_subsurface(shell->GetSubcompositor(),
+                                                  GetWLSurface(),
+                                                  parent_surface);
+    // Popups are drawn independently of their parent.
+    wl_subsurface_set_desync(subsurface_);
+  }
+
+  // The position is part of the pending state of the parent and applies with
+  // the next frame the parent swaps.
+  wl_subsurface_set_position(subsurface_, x, y);
+  WaylandShellSurface::FlushDisplay();
+}
+
+bool WaylandSubsurface::IsSubsurface() const {
+  return true;
+}
+
+void WaylandSubsurface::SetWindowTitle(const base::string16& title) {
+}
+
+void WaylandSubsurface::Maximize() {
+}
+
+void WaylandSubsurface::Minimize() {
+}
+
+}  // namespace ozonewayland
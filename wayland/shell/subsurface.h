@@ -0,0 +1,40 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OZONE_WAYLAND_SHELL_SUBSURFACE_H_
+#define OZONE_WAYLAND_SHELL_SUBSURFACE_H_
+
+#include "ozone/wayland/shell/shell_surface.h"
+
+namespace ozonewayland {
+
+class WaylandWindow;
+
+// Realizes a popup as a wl_subsurface of its parent rather than as a surface
+// of the shell. The compositor doesn't need to map and stack a new window, and
+// the popup moves along with its parent. There is no popup grab: presses
+// outside of the popup are detected by WaylandPointer.
+class WaylandSubsurface : public WaylandShellSurface {
+ public:
+  WaylandSubsurface();
+  virtual ~WaylandSubsurface();
+
+  virtual void InitializeShellSurface(WaylandWindow* window) OVERRIDE;
+  virtual void UpdateShellSurface(WaylandWindow::ShellType type,
+                                  WaylandShellSurface* shell_parent,
+                                  unsigned x,
+                                  unsigned y) OVERRIDE;
+  virtual void SetWindowTitle(const base::string16& title) OVERRIDE;
+  virtual void Maximize() OVERRIDE;
+  virtual void Minimize() OVERRIDE;
+  virtual bool IsSubsurface() const OVERRIDE;
+
+ private:
+  wl_subsurface* subsurface_;
+  DISALLOW_COPY_AND_ASSIGN(WaylandSubsurface);
+};
+
+}  // namespace ozonewayland
+
+#endif  // OZONE_WAYLAND_SHELL_SUBSURFACE_H_
@@ -97,6 +97,12 @@ void WebosShellSurface::Minimize() {
 void WebosShellSurface::HandleStateChanged(void* data,
                                      struct wl_webos_shell_surface* webos_shell_surface,
                                      uint32_t state) {
+  // The shell minimizes apps it takes off screen, e.g. when the panel is
+  // turned off or a screensaver is up.
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  WaylandDisplay::GetInstance()->OnWindowShellHidden(
+      window->Handle(), state == WL_WEBOS_SHELL_SURFACE_STATE_MINIMIZED);
+
 #if defined(WEBOS_BROWSER)
   if (webos::ShellUpdates::Get())
     webos::ShellUpdates::Get()->OnStateChanged(state);
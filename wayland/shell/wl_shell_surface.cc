@@ -54,11 +54,11 @@ void WLShellSurface::UpdateShellSurface(WaylandWindow::ShellType type,
     break;
   case WaylandWindow::POPUP: {
     WaylandDisplay* display = WaylandDisplay::GetInstance();
-    WaylandInputDevice* input_device = display->PrimaryInput();
+    WaylandInputDevice* input_device = display->ActiveInput();
     wl_surface* parent_surface = shell_parent->GetWLSurface();
     wl_shell_surface_set_popup(shell_surface_,
                                input_device->GetInputSeat(),
-                               display->GetSerial(),
+                               input_device->GetSerial(),
                                parent_surface,
                                x,
                                y,
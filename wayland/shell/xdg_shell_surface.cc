@@ -4,7 +4,9 @@
 
 #include "ozone/wayland/shell/xdg_shell_surface.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/strings/utf_string_conversions.h"
 
 #include "ozone/wayland/display.h"
@@ -18,7 +20,9 @@ XDGShellSurface::XDGShellSurface()
     : WaylandShellSurface(),
       xdg_surface_(NULL),
       xdg_popup_(NULL),
-      maximized_(false) {
+      minimize_pending_(false),
+      commit_scheduled_(false),
+      weak_factory_(this) {
 }
 
 XDGShellSurface::~XDGShellSurface() {
@@ -58,24 +62,21 @@ void XDGShellSurface::UpdateShellSurface(WaylandWindow::ShellType type,
                                          unsigned y) {
   switch (type) {
   case WaylandWindow::TOPLEVEL: {
-    if (maximized_) {
-      xdg_surface_request_change_state(xdg_surface_,
-                                       XDG_SURFACE_STATE_MAXIMIZED,
-                                       false, 0);
-      maximized_ = false;
-    }
+    base::AutoLock auto_lock(state_lock_);
+    pending_.maximized = false;
+    pending_.fullscreen = false;
     break;
   }
   case WaylandWindow::POPUP: {
     WaylandDisplay* display = WaylandDisplay::GetInstance();
-    WaylandInputDevice* input_device = display->PrimaryInput();
+    WaylandInputDevice* input_device = display->ActiveInput();
     wl_surface* surface = GetWLSurface();
     wl_surface* parent_surface = shell_parent->GetWLSurface();
     xdg_popup_ = xdg_shell_get_xdg_popup(display->GetShell()->GetXDGShell(),
                                          surface,
                                          parent_surface,
                                          input_device->GetInputSeat(),
-                                         display->GetSerial(),
+                                         input_device->GetSerial(),
                                          x,
                                          y,
                                          0);
@@ -88,11 +89,11 @@ void XDGShellSurface::UpdateShellSurface(WaylandWindow::ShellType type,
     DCHECK(xdg_popup_);
     break;
   }
-  case WaylandWindow::FULLSCREEN:
-    xdg_surface_request_change_state(xdg_surface_,
-                                     XDG_SURFACE_STATE_FULLSCREEN,
-                                     true, 0);
+  case WaylandWindow::FULLSCREEN: {
+    base::AutoLock auto_lock(state_lock_);
+    pending_.fullscreen = true;
     break;
+  }
   case WaylandWindow::CUSTOM:
       NOTREACHED() << "Unsupported shell type: " << type;
     break;
@@ -100,24 +101,88 @@ void XDGShellSurface::UpdateShellSurface(WaylandWindow::ShellType type,
       break;
   }
 
-  WaylandShellSurface::FlushDisplay();
+  ScheduleCommit();
 }
 
 void XDGShellSurface::SetWindowTitle(const base::string16& title) {
   xdg_surface_set_title(xdg_surface_, UTF16ToUTF8(title).c_str());
-  WaylandShellSurface::FlushDisplay();
+  ScheduleCommit();
 }
 
 void XDGShellSurface::Maximize() {
-  xdg_surface_request_change_state(xdg_surface_,
-                                   XDG_SURFACE_STATE_MAXIMIZED,
-                                   true, 0);
-  maximized_ = true;
-  WaylandShellSurface::FlushDisplay();
+  {
+    base::AutoLock auto_lock(state_lock_);
+    pending_.maximized = true;
+  }
+  ScheduleCommit();
 }
 
 void XDGShellSurface::Minimize() {
-  xdg_surface_set_minimized(xdg_surface_);
+  {
+    base::AutoLock auto_lock(state_lock_);
+    minimize_pending_ = true;
+  }
+  ScheduleCommit();
+}
+
+void XDGShellSurface::ScheduleCommit() {
+  if (commit_scheduled_)
+    return;
+
+  commit_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&XDGShellSurface::CommitPendingState,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void XDGShellSurface::CommitPendingState() {
+  commit_scheduled_ = false;
+  {
+    base::AutoLock auto_lock(state_lock_);
+    // Leaving fullscreen first lets the compositor restore the maximized
+    // state, if any, in a single step.
+    if (pending_.fullscreen != current_.fullscreen)
+      RequestChangeState(XDG_SURFACE_STATE_FULLSCREEN, pending_.fullscreen);
+    if (pending_.maximized != current_.maximized)
+      RequestChangeState(XDG_SURFACE_STATE_MAXIMIZED, pending_.maximized);
+    current_ = pending_;
+
+    if (minimize_pending_) {
+      xdg_surface_set_minimized(xdg_surface_);
+      minimize_pending_ = false;
+    }
+  }
+
+  WaylandShellSurface::FlushDisplay();
+}
+
+void XDGShellSurface::RequestChangeState(uint32_t state, bool value) {
+  state_lock_.AssertAcquired();
+  xdg_surface_request_change_state(xdg_surface_, state, value, 0);
+}
+
+void XDGShellSurface::OnStateChanged(uint32_t state, uint32_t value) {
+  base::AutoLock auto_lock(state_lock_);
+  // The compositor may change the states on its own, e.g. when the user
+  // maximizes the window from the shell. Follow it so that later requests
+  // are computed against what is actually applied. A state the browser
+  // changed since the last commit keeps its pending value, so that
+  // CommitPendingState() still sends it if it differs.
+  switch (state) {
+    case XDG_SURFACE_STATE_MAXIMIZED:
+      if (pending_.maximized == current_.maximized)
+        pending_.maximized = value;
+      current_.maximized = value;
+      break;
+    case XDG_SURFACE_STATE_FULLSCREEN:
+      if (pending_.fullscreen == current_.fullscreen)
+        pending_.fullscreen = value;
+      current_.fullscreen = value;
+      break;
+    default:
+      break;
+  }
 }
 
 void XDGShellSurface::HandleConfigure(void* data,
@@ -132,6 +197,11 @@ void XDGShellSurface::HandleChangeState(void* data,
                                  uint32_t state,
                                  uint32_t value,
                                  uint32_t serial) {
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  static_cast<XDGShellSurface*>(window->ShellSurface())->OnStateChanged(
+      state, value);
+  // Events are dispatched in order on the poll thread, which flushes the
+  // acks once it is done with them, so acks are never reordered.
   xdg_surface_ack_change_state(xdg_surface, state, value, serial);
 }
 
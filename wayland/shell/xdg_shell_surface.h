@@ -5,6 +5,8 @@
 #ifndef OZONE_WAYLAND_SHELL_XDG_SURFACE_H_
 #define OZONE_WAYLAND_SHELL_XDG_SURFACE_H_
 
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
 #include "ozone/wayland/shell/shell_surface.h"
 
 struct xdg_surface;
@@ -50,9 +52,39 @@ class XDGShellSurface : public WaylandShellSurface {
                                    uint32_t serial);
 
  private:
+  // The xdg_surface states of the window.
+  struct WindowState {
+    WindowState() : maximized(false), fullscreen(false) {}
+
+    bool maximized;
+    bool fullscreen;
+  };
+
+  // Changes requested by the browser are accumulated in |pending_| and sent
+  // by CommitPendingState(), which runs once all the changes posted together
+  // have been applied. Toggling a state back and forth in between sends
+  // nothing.
+  void ScheduleCommit();
+  void CommitPendingState();
+  void RequestChangeState(uint32_t state, bool value);
+
+  // Updates the states after a change_state event, on the poll thread.
+  void OnStateChanged(uint32_t state, uint32_t value);
+
   xdg_surface* xdg_surface_;
   xdg_popup* xdg_popup_;
-  bool maximized_;
+
+  // Protects the states below, which compositor initiated changes update from
+  // the poll thread.
+  base::Lock state_lock_;
+  // States wanted by the browser, not sent yet.
+  WindowState pending_;
+  // States last requested from, or set by, the compositor.
+  WindowState current_;
+  bool minimize_pending_;
+
+  bool commit_scheduled_;
+  base::WeakPtrFactory<XDGShellSurface> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(XDGShellSurface);
 };
 
@@ -0,0 +1,278 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ozone/wayland/shm/shm_buffer_pool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/synchronization/lock.h"
+
+namespace ozonewayland {
+
+namespace {
+
+// Number of buffers created up front, and the most a pool adds when the
+// compositor holds on to all of them.
+const size_t kMinBuffers = 3;
+const size_t kMaxBuffers = 5;
+
+base::LazyInstance<base::Lock>::Leaky g_buffer_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
+int CreateMemfd() {
+#if defined(__NR_memfd_create)
+  // MFD_CLOEXEC, the C library may not have the memfd definitions yet.
+  return syscall(__NR_memfd_create, "ozone-wayland-shm", 0x0001U);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+int CreateTmpfile() {
+  const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (!runtime_dir) {
+    LOG(ERROR) << "XDG_RUNTIME_DIR is not set";
+    return -1;
+  }
+
+  std::string path = std::string(runtime_dir) + "/ozone-wayland-shm-XXXXXX";
+  int fd = mkostemp(&path[0], O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  unlink(path.c_str());
+  return fd;
+}
+
+}  // namespace
+
+int CreateAnonymousFile(size_t size) {
+  int fd = CreateMemfd();
+  if (fd < 0)
+    fd = CreateTmpfile();
+
+  if (fd < 0) {
+    PLOG(ERROR) << "Failed to create a shared memory file";
+    return -1;
+  }
+
+  if (HANDLE_EINTR(ftruncate(fd, size)) < 0) {
+    PLOG(ERROR) << "Failed to allocate " << size << " bytes of shared memory";
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+WaylandShmBufferPool::WaylandShmBufferPool(struct wl_shm* shm)
+    : shm_(shm),
+      pool_(NULL),
+      fd_(-1),
+      memory_(NULL),
+      pool_size_(0),
+      width_(0),
+      height_(0),
+      stride_(0),
+      front_index_(0),
+      back_index_(0),
+      next_index_(0) {
+  DCHECK(shm_);
+}
+
+WaylandShmBufferPool::~WaylandShmBufferPool() {
+  DetachBuffers();
+  DestroyPool();
+}
+
+bool WaylandShmBufferPool::Resize(int width, int height) {
+  if (width == width_ && height == height_ && !buffers_.empty())
+    return true;
+
+  // The compositor may still read from busy buffers. Rather than overwriting
+  // them with buffers of the new size, start a new pool. The compositor keeps
+  // its own mapping of the old one.
+  if (DetachBuffers())
+    DestroyPool();
+
+  width_ = width;
+  height_ = height;
+  stride_ = width * 4;
+  for (size_t i = 0; i < kMinBuffers; ++i) {
+    if (!AddBuffer()) {
+      DetachBuffers();
+      return false;
+    }
+  }
+
+  front_index_ = buffers_.size() - 1;
+  back_index_ = 0;
+  next_index_ = 0;
+  // The first frame of a new size is drawn in full.
+  back()->damage = gfx::Rect();
+  return true;
+}
+
+bool WaylandShmBufferPool::PrepareSwap() {
+  {
+    base::AutoLock auto_lock(g_buffer_lock.Get());
+    // Start with the buffer following the back one, the least recently
+    // presented one when the compositor releases them in order.
+    for (size_t i = 1; i < buffers_.size(); ++i) {
+      size_t index = (back_index_ + i) % buffers_.size();
+      if (!buffers_[index]->busy) {
+        next_index_ = index;
+        return true;
+      }
+    }
+  }
+
+  if (buffers_.size() >= kMaxBuffers || !AddBuffer())
+    return false;
+
+  DVLOG(1) << "The compositor holds all shm buffers, added one";
+  next_index_ = buffers_.size() - 1;
+  return true;
+}
+
+void WaylandShmBufferPool::SwapBuffers(const gfx::Rect& damage) {
+  DCHECK_NE(back_index_, next_index_);
+  base::AutoLock auto_lock(g_buffer_lock.Get());
+  back()->busy = true;
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    if (i != back_index_)
+      buffers_[i]->damage.Union(damage);
+  }
+  front_index_ = back_index_;
+  back_index_ = next_index_;
+}
+
+bool WaylandShmBufferPool::DetachBuffers() {
+  bool any_busy = false;
+  base::AutoLock auto_lock(g_buffer_lock.Get());
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    Buffer* buffer = buffers_[i];
+    if (buffer->busy) {
+      buffer->detached = true;
+      any_busy = true;
+      continue;
+    }
+
+    wl_buffer_destroy(buffer->buffer);
+    delete buffer;
+  }
+  buffers_.clear();
+  return any_busy;
+}
+
+void WaylandShmBufferPool::DestroyPool() {
+  if (pool_)
+    wl_shm_pool_destroy(pool_);
+  if (memory_)
+    munmap(memory_, pool_size_);
+  if (fd_ >= 0)
+    close(fd_);
+  pool_ = NULL;
+  memory_ = NULL;
+  pool_size_ = 0;
+  fd_ = -1;
+}
+
+bool WaylandShmBufferPool::EnsurePoolSize(size_t size) {
+  if (size <= pool_size_)
+    return true;
+
+  // wl_shm_pool can only grow. Leave some room so that growing a window a
+  // few pixels at a time doesn't remap the pool every frame.
+  size_t new_size = std::max(size, pool_size_ + pool_size_ / 2);
+  if (fd_ < 0) {
+    fd_ = CreateAnonymousFile(new_size);
+    if (fd_ < 0)
+      return false;
+  } else if (HANDLE_EINTR(ftruncate(fd_, new_size)) < 0) {
+    PLOG(ERROR) << "Failed to grow the shared memory pool";
+    return false;
+  }
+
+  if (memory_)
+    munmap(memory_, pool_size_);
+  void* memory =
+      mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (memory == MAP_FAILED) {
+    PLOG(ERROR) << "Failed to map the shared memory pool";
+    memory_ = NULL;
+    pool_size_ = 0;
+    return false;
+  }
+
+  memory_ = static_cast<uint8*>(memory);
+  if (pool_)
+    wl_shm_pool_resize(pool_, new_size);
+  else
+    pool_ = wl_shm_create_pool(shm_, fd_, new_size);
+  pool_size_ = new_size;
+
+  for (size_t i = 0; i < buffers_.size(); ++i)
+    buffers_[i]->data = memory_ + buffers_[i]->offset;
+  return true;
+}
+
+bool WaylandShmBufferPool::AddBuffer() {
+  static const struct wl_buffer_listener kBufferListener = {
+    WaylandShmBufferPool::BufferRelease
+  };
+
+  size_t buffer_size = static_cast<size_t>(stride_) * height_;
+  size_t offset = buffers_.size() * buffer_size;
+  if (!EnsurePoolSize(offset + buffer_size))
+    return false;
+
+  struct wl_buffer* wl_buffer =
+      wl_shm_pool_create_buffer(pool_,
+                                offset,
+                                width_,
+                                height_,
+                                stride_,
+                                WL_SHM_FORMAT_ARGB8888);
+  if (!wl_buffer)
+    return false;
+
+  Buffer* buffer = new Buffer();
+  buffer->buffer = wl_buffer;
+  buffer->data = memory_ + offset;
+  buffer->offset = offset;
+  // Nothing was drawn into the buffer yet.
+  buffer->damage = gfx::Rect(width_, height_);
+  wl_buffer_add_listener(wl_buffer, &kBufferListener, buffer);
+  buffers_.push_back(buffer);
+  return true;
+}
+
+// static
+void WaylandShmBufferPool::BufferRelease(void* data,
+                                         struct wl_buffer* wl_buffer) {
+  base::AutoLock auto_lock(g_buffer_lock.Get());
+  Buffer* buffer = static_cast<Buffer*>(data);
+  if (!buffer->detached) {
+    buffer->busy = false;
+    return;
+  }
+
+  wl_buffer_destroy(buffer->buffer);
+  delete buffer;
+}
+
+}  // namespace ozonewayland
@@ -0,0 +1,112 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OZONE_WAYLAND_SHM_SHM_BUFFER_POOL_H_
+#define OZONE_WAYLAND_SHM_SHM_BUFFER_POOL_H_
+
+#include <wayland-client.h>
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "ui/gfx/rect.h"
+
+namespace ozonewayland {
+
+// Returns a file descriptor to an anonymous file of |size| bytes suitable for
+// sharing with the compositor through wl_shm, or -1 on failure. Uses a
+// memfd when the kernel supports it, a file unlinked from XDG_RUNTIME_DIR
+// otherwise. The caller owns the descriptor.
+int CreateAnonymousFile(size_t size);
+
+// ARGB8888 wl_buffers carved out of a single wl_shm_pool, used as the front
+// and back buffers of a software rendered surface. Buffers are reused once the
+// compositor releases them. Three are created up front so that drawing goes on
+// while the compositor still holds the previous frame, more are added should
+// the compositor hold on to all of them. Resizing recreates the wl_buffers in
+// place when the pool is large enough and no buffer is busy.
+class WaylandShmBufferPool {
+ public:
+  struct Buffer {
+    Buffer()
+        : buffer(NULL), data(NULL), offset(0), busy(false), detached(false) {}
+
+    struct wl_buffer* buffer;
+    uint8* data;
+    // Offset of the buffer in the pool.
+    size_t offset;
+    // Set while the compositor may read from the buffer.
+    bool busy;
+    // Set once the pool dropped the buffer while it was busy. The buffer is
+    // then destroyed when the compositor releases it.
+    bool detached;
+    // Area which changed in the frames presented since the buffer was last
+    // drawn into.
+    gfx::Rect damage;
+  };
+
+  explicit WaylandShmBufferPool(struct wl_shm* shm);
+  ~WaylandShmBufferPool();
+
+  // Sets the size of the buffers. Returns false if the pool could not be
+  // allocated.
+  bool Resize(int width, int height);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int stride() const { return stride_; }
+
+  // The buffer to draw into next, which the compositor doesn't hold. Its
+  // contents are those of the last frame drawn into it, see Buffer::damage.
+  Buffer* back() { return buffers_[back_index_]; }
+  // The buffer presented last.
+  Buffer* front() { return buffers_[front_index_]; }
+
+  // Picks the buffer to draw into after the back buffer is presented, among
+  // the ones the compositor doesn't hold, adding one if needed. Never waits.
+  // Returns false if the compositor holds too many buffers, the frame in the
+  // back buffer should then be held back. Data pointers of the buffers may
+  // change.
+  bool PrepareSwap();
+
+  // Marks the back buffer busy and makes it the front buffer, adding |damage|
+  // to the other buffers. The buffer picked by PrepareSwap() becomes the back
+  // buffer. Call after attaching back()->buffer to the surface.
+  void SwapBuffers(const gfx::Rect& damage);
+
+ private:
+  // Drops all buffers, leaving the busy ones to BufferRelease(). Returns true
+  // if any was busy.
+  bool DetachBuffers();
+  // Unmaps and closes the pool.
+  void DestroyPool();
+  // Grows the pool to at least |size| bytes.
+  bool EnsurePoolSize(size_t size);
+  bool AddBuffer();
+
+  static void BufferRelease(void* data, struct wl_buffer* buffer);
+
+  struct wl_shm* shm_;
+  struct wl_shm_pool* pool_;
+  int fd_;
+  uint8* memory_;
+  size_t pool_size_;
+
+  int width_;
+  int height_;
+  int stride_;
+
+  // The busy and detached flags of the buffers are protected by a lock shared
+  // by all pools, as buffers may outlive their pool.
+  std::vector<Buffer*> buffers_;
+  size_t front_index_;
+  size_t back_index_;
+  size_t next_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(WaylandShmBufferPool);
+};
+
+}  // namespace ozonewayland
+
+#endif  // OZONE_WAYLAND_SHM_SHM_BUFFER_POOL_H_
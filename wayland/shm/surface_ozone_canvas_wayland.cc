@@ -0,0 +1,115 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ozone/wayland/shm/surface_ozone_canvas_wayland.h"
+
+#include <string.h>
+
+#include "ozone/ui/gfx/vsync_provider_wayland.h"
+#include "ozone/wayland/display.h"
+#include "ozone/wayland/shell/shell_surface.h"
+#include "ozone/wayland/shm/shm_buffer_pool.h"
+#include "ozone/wayland/window.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace ozonewayland {
+
+SurfaceOzoneCanvasWayland::SurfaceOzoneCanvasWayland(WaylandWindow* window)
+    : window_(window),
+      pool_(new WaylandShmBufferPool(WaylandDisplay::GetInstance()->shm())) {
+  DCHECK(window_ && window_->ShellSurface());
+  ResizeCanvas(window_->GetBounds().size());
+}
+
+SurfaceOzoneCanvasWayland::~SurfaceOzoneCanvasWayland() {
+  // The buffers must go before the surface they may be attached to.
+  surface_.clear();
+  pool_.reset();
+  WaylandDisplay::GetInstance()->DestroyWindow(window_->Handle());
+  WaylandDisplay::GetInstance()->FlushDisplay();
+}
+
+skia::RefPtr<SkCanvas> SurfaceOzoneCanvasWayland::GetCanvas() {
+  DCHECK(surface_);
+  return skia::SharePtr(surface_->getCanvas());
+}
+
+void SurfaceOzoneCanvasWayland::ResizeCanvas(const gfx::Size& viewport_size) {
+  window_->Resize(viewport_size.width(), viewport_size.height());
+  if (pool_->width() == viewport_size.width() &&
+      pool_->height() == viewport_size.height() && surface_) {
+    return;
+  }
+
+  surface_.clear();
+  held_damage_ = gfx::Rect();
+  if (!pool_->Resize(viewport_size.width(), viewport_size.height())) {
+    LOG(ERROR) << "Failed to allocate buffers of size "
+               << viewport_size.ToString();
+    return;
+  }
+
+  UpdateSkSurface();
+}
+
+void SurfaceOzoneCanvasWayland::PresentCanvas(const gfx::Rect& damage) {
+  if (!surface_)
+    return;
+
+  struct wl_surface* surface = window_->ShellSurface()->GetWLSurface();
+  gfx::Rect bounds(pool_->width(), pool_->height());
+  held_damage_.Union(gfx::IntersectRects(damage, bounds));
+
+  // Callers only repaint what changed, so a frame which can't be presented
+  // now stays in the back buffer and goes out with the next one.
+  if (!pool_->PrepareSwap()) {
+    DVLOG(1) << "The compositor holds all shm buffers, holding a frame back";
+    return;
+  }
+
+  gfx::Rect frame_damage = held_damage_;
+  held_damage_ = gfx::Rect();
+  wl_surface_attach(surface, pool_->back()->buffer, 0, 0);
+  wl_surface_damage(surface,
+                    frame_damage.x(),
+                    frame_damage.y(),
+                    frame_damage.width(),
+                    frame_damage.height());
+  wl_surface_commit(surface);
+  WaylandDisplay::GetInstance()->FlushDisplay();
+  pool_->SwapBuffers(frame_damage);
+  window_->OnFrameSwapped();
+
+  // Bring the new back buffer up to date with the frames presented since it
+  // was last drawn into.
+  WaylandShmBufferPool::Buffer* back = pool_->back();
+  gfx::Rect stale = gfx::IntersectRects(back->damage, bounds);
+  if (!stale.IsEmpty()) {
+    const uint8* src = pool_->front()->data;
+    int stride = pool_->stride();
+    for (int y = stale.y(); y < stale.bottom(); ++y) {
+      size_t offset = y * stride + stale.x() * 4;
+      memcpy(back->data + offset, src + offset, stale.width() * 4);
+    }
+  }
+  back->damage = gfx::Rect();
+
+  UpdateSkSurface();
+}
+
+scoped_ptr<gfx::VSyncProvider>
+SurfaceOzoneCanvasWayland::CreateVSyncProvider() {
+  return scoped_ptr<gfx::VSyncProvider>(new gfx::WaylandSyncProvider());
+}
+
+void SurfaceOzoneCanvasWayland::UpdateSkSurface() {
+  SkImageInfo info = SkImageInfo::MakeN32Premul(pool_->width(),
+                                                pool_->height());
+  surface_ = skia::AdoptRef(SkSurface::NewRasterDirect(info,
+                                                      pool_->back()->data,
+                                                      pool_->stride()));
+}
+
+}  // namespace ozonewayland
@@ -0,0 +1,50 @@
+// Copyright 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OZONE_WAYLAND_SHM_SURFACE_OZONE_CANVAS_WAYLAND_H_
+#define OZONE_WAYLAND_SHM_SURFACE_OZONE_CANVAS_WAYLAND_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "skia/ext/refptr.h"
+#include "ui/gfx/rect.h"
+#include "ui/ozone/public/surface_ozone_canvas.h"
+
+class SkSurface;
+
+namespace ozonewayland {
+
+class WaylandShmBufferPool;
+class WaylandWindow;
+
+// Provides software rendering for SurfaceOzone, drawing into wl_shm buffers.
+class SurfaceOzoneCanvasWayland : public ui::SurfaceOzoneCanvas {
+ public:
+  // |window| must have been realized. It is destroyed together with this
+  // surface.
+  explicit SurfaceOzoneCanvasWayland(WaylandWindow* window);
+  virtual ~SurfaceOzoneCanvasWayland();
+
+  // SurfaceOzoneCanvas:
+  virtual skia::RefPtr<SkCanvas> GetCanvas() OVERRIDE;
+  virtual void ResizeCanvas(const gfx::Size& viewport_size) OVERRIDE;
+  virtual void PresentCanvas(const gfx::Rect& damage) OVERRIDE;
+  virtual scoped_ptr<gfx::VSyncProvider> CreateVSyncProvider() OVERRIDE;
+
+ private:
+  // Points |surface_| to the back buffer of |pool_|.
+  void UpdateSkSurface();
+
+  WaylandWindow* window_;
+  scoped_ptr<WaylandShmBufferPool> pool_;
+  skia::RefPtr<SkSurface> surface_;
+  // Area changed since the last frame which was presented.
+  gfx::Rect held_damage_;
+
+  DISALLOW_COPY_AND_ASSIGN(SurfaceOzoneCanvasWayland);
+};
+
+}  // namespace ozonewayland
+
+#endif  // OZONE_WAYLAND_SHM_SURFACE_OZONE_CANVAS_WAYLAND_H_
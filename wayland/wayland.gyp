@@ -53,6 +53,7 @@
       },
       'dependencies': [
         '../../base/base.gyp:base',
+        '../../skia/skia.gyp:skia',
       ],
       'include_dirs': [
         '../..',
@@ -71,6 +72,8 @@
         'window.h',
         'egl/egl_window.cc',
         'egl/egl_window.h',
+        'egl/frame_throttle.cc',
+        'egl/frame_throttle.h',
         'egl/surface_ozone_wayland.cc',
         'egl/surface_ozone_wayland.h',
         'input/cursor.cc',
@@ -81,18 +84,30 @@
         'input/keyboard_engine_xkb.cc',
         'input/pointer.cc',
         'input/pointer.h',
+        'input/pointer-constraints-unstable-v1-protocol.c',
+        'input/pointer-constraints-unstable-v1-client-protocol.h',
+        'input/relative-pointer-unstable-v1-protocol.c',
+        'input/relative-pointer-unstable-v1-client-protocol.h',
         'input/text_input.h',
         'input/text_input.cc',
         'input/text-protocol.c',
         'input/text-client-protocol.h',
         'input/touchscreen.cc',
         'input/touchscreen.h',
+        'input/wlr-output-power-management-unstable-v1-protocol.c',
+        'input/wlr-output-power-management-unstable-v1-client-protocol.h',
         'shell/shell.cc',
         'shell/shell.h',
         'shell/shell_surface.h',
         'shell/shell_surface.cc',
+        'shell/subsurface.cc',
+        'shell/subsurface.h',
         'shell/wl_shell_surface.cc',
         'shell/wl_shell_surface.h',
+        'shm/shm_buffer_pool.cc',
+        'shm/shm_buffer_pool.h',
+        'shm/surface_ozone_canvas_wayland.cc',
+        'shm/surface_ozone_canvas_wayland.h',
       ],
       'conditions': [
         ['<(enable_ozone_wayland_vkb)==1', {
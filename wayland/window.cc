@@ -5,23 +5,57 @@
 
 #include "ozone/wayland/window.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
+#include "ozone/ui/events/event_factory_ozone_wayland.h"
 #include "ozone/wayland/display.h"
 #include "ozone/wayland/egl/egl_window.h"
+#include "ozone/wayland/input/pointer.h"
 #include "ozone/wayland/input_device.h"
+#include "ozone/wayland/screen.h"
 #include "ozone/wayland/shell/shell.h"
 #include "ozone/wayland/shell/shell_surface.h"
 
 namespace ozonewayland {
 
+namespace {
+
+// Returns the pointer of the seat in use, or of the first seat with one if
+// the seat in use has none.
+WaylandPointer* GetActivePointer() {
+  WaylandDisplay* display = WaylandDisplay::GetInstance();
+  WaylandInputDevice* active = display->ActiveInput();
+  if (active && active->GetPointer())
+    return active->GetPointer();
+
+  const std::list<WaylandInputDevice*>& inputs = display->GetInputList();
+  for (std::list<WaylandInputDevice*>::const_iterator i = inputs.begin();
+       i != inputs.end(); ++i) {
+    if ((*i)->GetPointer())
+      return (*i)->GetPointer();
+  }
+
+  return NULL;
+}
+
+}  // namespace
+
 WaylandWindow::WaylandWindow(unsigned handle) : shell_surface_(NULL),
     window_(NULL),
     type_(None),
     handle_(handle),
+    opaque_(false),
+    locked_pointer_(NULL),
+    confined_pointer_(NULL),
+    pointer_locked_(false),
+    shell_hidden_(false),
+    blanked_(false),
     allocation_(gfx::Rect(0, 0, 1, 1)) {
 }
 
 WaylandWindow::~WaylandWindow() {
+  UnconstrainPointer();
   delete window_;
   delete shell_surface_;
 }
@@ -33,6 +67,7 @@ void WaylandWindow::SetShellAttributes(ShellType type) {
   if (!shell_surface_) {
     shell_surface_ =
         WaylandDisplay::GetInstance()->GetShell()->CreateShellSurface(this);
+    TrackSurfaceOutputs();
   }
 
   type_ = type;
@@ -46,9 +81,12 @@ void WaylandWindow::SetShellAttributes(ShellType type,
   DCHECK(shell_parent && (type == POPUP));
 
   if (!shell_surface_) {
-    shell_surface_ =
-        WaylandDisplay::GetInstance()->GetShell()->CreateShellSurface(this);
-    WaylandInputDevice* input = WaylandDisplay::GetInstance()->PrimaryInput();
+    WaylandShell* shell = WaylandDisplay::GetInstance()->GetShell();
+    shell_surface_ = shell->CreateSubsurface(this);
+    if (!shell_surface_)
+      shell_surface_ = shell->CreateShellSurface(this);
+    TrackSurfaceOutputs();
+    WaylandInputDevice* input = WaylandDisplay::GetInstance()->ActiveInput();
     input->SetGrabWindowHandle(handle_, 0);
   }
 
@@ -81,7 +119,125 @@ void WaylandWindow::SetFullscreen() {
     shell_surface_->UpdateShellSurface(FULLSCREEN, NULL, 0, 0);
 }
 
-void WaylandWindow::RealizeAcceleratedWidget() {
+void WaylandWindow::SetOpaque(bool opaque) {
+  if (opaque_ == opaque)
+    return;
+
+  opaque_ = opaque;
+  UpdateOpaqueRegion();
+}
+
+void WaylandWindow::LockPointer() {
+  static const struct zwp_locked_pointer_v1_listener kLockedPointerListener = {
+    WaylandWindow::OnPointerLocked,
+    WaylandWindow::OnPointerUnlocked
+  };
+
+  base::AutoLock auto_lock(constraint_lock_);
+  if (locked_pointer_)
+    return;
+
+  WaylandDisplay* display = WaylandDisplay::GetInstance();
+  WaylandPointer* pointer = GetActivePointer();
+  if (!display->GetPointerConstraints() || !shell_surface_ || !pointer ||
+      !pointer->GetInputPointer()) {
+    return;
+  }
+
+  // A surface can only have one constraint per pointer.
+  DestroyPointerConstraint();
+  // Oneshot, the lock ends for good when the window loses focus, like Pointer
+  // Lock does.
+  locked_pointer_ = zwp_pointer_constraints_v1_lock_pointer(
+      display->GetPointerConstraints(),
+      shell_surface_->GetWLSurface(),
+      pointer->GetInputPointer(),
+      NULL,
+      ZWP_POINTER_CONSTRAINTS_V1_LIFETIME_ONESHOT);
+  zwp_locked_pointer_v1_add_listener(locked_pointer_,
+                                     &kLockedPointerListener,
+                                     this);
+}
+
+void WaylandWindow::ConfinePointer() {
+  static const struct zwp_confined_pointer_v1_listener
+      kConfinedPointerListener = {
+    WaylandWindow::OnPointerConfined,
+    WaylandWindow::OnPointerUnconfined
+  };
+
+  base::AutoLock auto_lock(constraint_lock_);
+  if (confined_pointer_)
+    return;
+
+  WaylandDisplay* display = WaylandDisplay::GetInstance();
+  WaylandPointer* pointer = GetActivePointer();
+  if (!display->GetPointerConstraints() || !shell_surface_ || !pointer ||
+      !pointer->GetInputPointer()) {
+    return;
+  }
+
+  DestroyPointerConstraint();
+  confined_pointer_ = zwp_pointer_constraints_v1_confine_pointer(
+      display->GetPointerConstraints(),
+      shell_surface_->GetWLSurface(),
+      pointer->GetInputPointer(),
+      NULL,
+      ZWP_POINTER_CONSTRAINTS_V1_LIFETIME_ONESHOT);
+  zwp_confined_pointer_v1_add_listener(confined_pointer_,
+                                       &kConfinedPointerListener,
+                                       this);
+}
+
+void WaylandWindow::UnconstrainPointer() {
+  base::AutoLock auto_lock(constraint_lock_);
+  DestroyPointerConstraint();
+}
+
+bool WaylandWindow::IsPointerLocked() const {
+  base::AutoLock auto_lock(constraint_lock_);
+  return pointer_locked_;
+}
+
+void WaylandWindow::DestroyPointerConstraint() {
+  pointer_locked_ = false;
+  if (locked_pointer_) {
+    zwp_locked_pointer_v1_destroy(locked_pointer_);
+    locked_pointer_ = NULL;
+  }
+
+  if (confined_pointer_) {
+    zwp_confined_pointer_v1_destroy(confined_pointer_);
+    confined_pointer_ = NULL;
+  }
+}
+
+void WaylandWindow::OnOutputPowerChanged(WaylandScreen* screen) {
+  if (IsOnScreen(screen))
+    UpdateBlanked();
+}
+
+void WaylandWindow::SetShellHidden(bool hidden) {
+  if (shell_hidden_ == hidden)
+    return;
+
+  shell_hidden_ = hidden;
+  UpdateBlanked();
+}
+
+void WaylandWindow::EnterScreen(WaylandScreen* screen) {
+  if (std::find(screens_.begin(), screens_.end(), screen) == screens_.end())
+    screens_.push_back(screen);
+  UpdateBlanked();
+}
+
+void WaylandWindow::LeaveScreen(WaylandScreen* screen) {
+  screens_.erase(std::remove(screens_.begin(), screens_.end(), screen),
+                 screens_.end());
+  UpdateBlanked();
+}
+
+void WaylandWindow::RealizeShellSurface() {
   if (!shell_surface_) {
     LOG(ERROR) << "Shell type not set. Setting it to TopLevel";
 #if defined(WEBOS)
@@ -90,11 +246,16 @@ void WaylandWindow::RealizeAcceleratedWidget() {
     SetShellAttributes(TOPLEVEL);
 #endif
   }
+}
 
-  if (!window_)
+void WaylandWindow::RealizeAcceleratedWidget() {
+  RealizeShellSurface();
+  if (!window_) {
     window_ = new EGLWindow(shell_surface_->GetWLSurface(),
                             allocation_.width(),
                             allocation_.height());
+    UpdateOpaqueRegion();
+  }
 }
 
 wl_egl_window* WaylandWindow::egl_window() const {
@@ -107,13 +268,143 @@ void WaylandWindow::Resize(unsigned width, unsigned height) {
     return;
 
   allocation_ = gfx::Rect(allocation_.x(), allocation_.y(), width, height);
-  if (!shell_surface_ || !window_)
+  if (!shell_surface_)
     return;
 
-  window_->Resize(width, height);
-  WaylandDisplay* display = WaylandDisplay::GetInstance();
-  DCHECK(display);
-  display->FlushDisplay();
+  shell_surface_->OnResized(this, width, height);
+
+  // wl_egl_window_resize doesn't send any request, and the opaque region is
+  // committed along with the next frame, so there is nothing to flush here.
+  if (window_)
+    window_->Resize(width, height);
+  UpdateOpaqueRegion();
+}
+
+void WaylandWindow::OnFrameSwapped() {
+  if (shell_surface_)
+    shell_surface_->OnFrameSwapped(this);
+}
+
+void WaylandWindow::UpdateOpaqueRegion() {
+  if (!shell_surface_)
+    return;
+
+  struct wl_surface* surface = shell_surface_->GetWLSurface();
+  if (!opaque_) {
+    wl_surface_set_opaque_region(surface, NULL);
+    return;
+  }
+
+  struct wl_region* region = wl_compositor_create_region(
+      WaylandDisplay::GetInstance()->GetCompositor());
+  wl_region_add(region, 0, 0, allocation_.width(), allocation_.height());
+  wl_surface_set_opaque_region(surface, region);
+  wl_region_destroy(region);
+}
+
+void WaylandWindow::TrackSurfaceOutputs() {
+  static const struct wl_surface_listener kSurfaceListener = {
+    WaylandWindow::OnSurfaceEnter,
+    WaylandWindow::OnSurfaceLeave
+  };
+
+  wl_surface_add_listener(shell_surface_->GetWLSurface(),
+                          &kSurfaceListener,
+                          this);
+  // The output may already be off, in which case the compositor might not
+  // bother to show the surface on it.
+  UpdateBlanked();
+}
+
+bool WaylandWindow::IsOnScreen(WaylandScreen* screen) const {
+  if (screens_.empty())
+    return screen == WaylandDisplay::GetInstance()->PrimaryScreen();
+
+  return std::find(screens_.begin(), screens_.end(), screen) !=
+      screens_.end();
+}
+
+void WaylandWindow::UpdateBlanked() {
+  bool blanked = shell_hidden_;
+  if (!blanked && screens_.empty()) {
+    WaylandScreen* screen = WaylandDisplay::GetInstance()->PrimaryScreen();
+    blanked = screen && !screen->IsPoweredOn();
+  } else if (!blanked) {
+    // Blanked only if every output showing the window is off.
+    blanked = true;
+    for (std::vector<WaylandScreen*>::const_iterator i = screens_.begin();
+         i != screens_.end(); ++i) {
+      if ((*i)->IsPoweredOn()) {
+        blanked = false;
+        break;
+      }
+    }
+  }
+
+  if (blanked_ == blanked)
+    return;
+
+  blanked_ = blanked;
+  ui::EventFactoryOzoneWayland::GetInstance()->EventConverter()->
+      WindowBlanked(handle_, blanked_);
+}
+
+// static
+void WaylandWindow::OnSurfaceEnter(void* data,
+                                   struct wl_surface* surface,
+                                   struct wl_output* output) {
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  WaylandDisplay::GetInstance()->OnWindowOutputChanged(window->Handle(),
+                                                       output,
+                                                       true);
+}
+
+// static
+void WaylandWindow::OnSurfaceLeave(void* data,
+                                   struct wl_surface* surface,
+                                   struct wl_output* output) {
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  WaylandDisplay::GetInstance()->OnWindowOutputChanged(window->Handle(),
+                                                       output,
+                                                       false);
+}
+
+// static
+void WaylandWindow::OnPointerLocked(
+    void* data,
+    struct zwp_locked_pointer_v1* locked_pointer) {
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  base::AutoLock auto_lock(window->constraint_lock_);
+  // The GPU thread may have replaced the lock meanwhile.
+  if (window->locked_pointer_ == locked_pointer)
+    window->pointer_locked_ = true;
+}
+
+// static
+void WaylandWindow::OnPointerUnlocked(
+    void* data,
+    struct zwp_locked_pointer_v1* locked_pointer) {
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  base::AutoLock auto_lock(window->constraint_lock_);
+  // The lock is oneshot, so it is defunct now.
+  if (window->locked_pointer_ == locked_pointer)
+    window->DestroyPointerConstraint();
+}
+
+// static
+void WaylandWindow::OnPointerConfined(
+    void* data,
+    struct zwp_confined_pointer_v1* confined_pointer) {
+}
+
+// static
+void WaylandWindow::OnPointerUnconfined(
+    void* data,
+    struct zwp_confined_pointer_v1* confined_pointer) {
+  WaylandWindow* window = static_cast<WaylandWindow*>(data);
+  base::AutoLock auto_lock(window->constraint_lock_);
+  if (window->confined_pointer_ == confined_pointer)
+    window->DestroyPointerConstraint();
 }
 
 }  // namespace ozonewayland
@@ -8,11 +8,16 @@
 
 #include <wayland-client.h>
 
+#include <vector>
+
 #include "base/strings/string16.h"
+#include "base/synchronization/lock.h"
+#include "ozone/wayland/input/pointer-constraints-unstable-v1-client-protocol.h"
 #include "ui/gfx/rect.h"
 
 namespace ozonewayland {
 
+class WaylandScreen;
 class WaylandShellSurface;
 class EGLWindow;
 struct wl_egl_window;
@@ -43,27 +48,101 @@ class WaylandWindow {
   void Minimize();
   void Restore();
   void SetFullscreen();
+  // Tells the compositor whether the window contents are fully opaque. Windows
+  // are assumed to be translucent until told otherwise.
+  void SetOpaque(bool opaque);
+
+  // Locks the pointer in place while it is over the window, so that it only
+  // reports relative motion, or confines it to the window, until
+  // UnconstrainPointer(). The compositor activates the constraint once the
+  // window has pointer focus, and may end it at any time. Does nothing if the
+  // compositor doesn't support pointer constraints.
+  void LockPointer();
+  void ConfinePointer();
+  void UnconstrainPointer();
+  // Returns whether the compositor locked the pointer. Called on the thread
+  // dispatching Wayland events.
+  bool IsPointerLocked() const;
+
+  // A window is blanked while nothing of it can be seen, because the outputs
+  // showing it are powered off or the shell took it off screen. The browser
+  // stops drawing into blanked windows. Called on the GPU thread, through
+  // WaylandDisplay.
+  void OnOutputPowerChanged(WaylandScreen* screen);
+  void SetShellHidden(bool hidden);
+  void EnterScreen(WaylandScreen* screen);
+  void LeaveScreen(WaylandScreen* screen);
 
   ShellType Type() const { return type_; }
   unsigned Handle() const { return handle_; }
   WaylandShellSurface* ShellSurface() const { return shell_surface_; }
 
+  // Creates the surface of the window if needed, as a toplevel unless the
+  // shell type was set.
+  void RealizeShellSurface();
   void RealizeAcceleratedWidget();
 
   // Returns pointer to egl window associated with the window.
   // The WaylandWindow object owns the pointer.
   wl_egl_window* egl_window() const;
 
-  // Immediately Resizes window and flushes Wayland Display.
+  // Resizes the window. The new size takes effect with the next frame drawn
+  // into it, so repeated resizes between two frames allocate buffers once.
   void Resize(unsigned width, unsigned height);
+  // Called once a frame of the window has been swapped.
+  void OnFrameSwapped();
   gfx::Rect GetBounds() const { return allocation_; }
 
  private:
+  // Sets the opaque region of the surface to cover the whole window if it is
+  // opaque. Takes effect with the next commit, i.e. the next swap.
+  void UpdateOpaqueRegion();
+
+  // Follows the outputs the surface is shown on.
+  void TrackSurfaceOutputs();
+  // Returns whether the window is shown on |screen|. Windows are assumed to be
+  // on the primary screen until the compositor says otherwise.
+  bool IsOnScreen(WaylandScreen* screen) const;
+  // Tells the browser if the window got blanked or unblanked.
+  void UpdateBlanked();
+  // Destroys the pointer constraint. |constraint_lock_| must be held.
+  void DestroyPointerConstraint();
+
+  static void OnSurfaceEnter(void* data,
+                             struct wl_surface* surface,
+                             struct wl_output* output);
+  static void OnSurfaceLeave(void* data,
+                             struct wl_surface* surface,
+                             struct wl_output* output);
+
+  static void OnPointerLocked(void* data,
+                              struct zwp_locked_pointer_v1* locked_pointer);
+  static void OnPointerUnlocked(void* data,
+                                struct zwp_locked_pointer_v1* locked_pointer);
+  static void OnPointerConfined(
+      void* data,
+      struct zwp_confined_pointer_v1* confined_pointer);
+  static void OnPointerUnconfined(
+      void* data,
+      struct zwp_confined_pointer_v1* confined_pointer);
+
   WaylandShellSurface* shell_surface_;
   EGLWindow* window_;
 
   ShellType type_;
   unsigned handle_;
+  bool opaque_;
+  // Protects the pointer constraint, which is requested on the GPU thread
+  // and ended by the compositor on the thread dispatching Wayland events.
+  mutable base::Lock constraint_lock_;
+  // At most one of these is set. They are destroyed as soon as the
+  // compositor ends them, so that the window can be constrained again.
+  struct zwp_locked_pointer_v1* locked_pointer_;
+  struct zwp_confined_pointer_v1* confined_pointer_;
+  bool pointer_locked_;
+  std::vector<WaylandScreen*> screens_;
+  bool shell_hidden_;
+  bool blanked_;
   gfx::Rect allocation_;
   DISALLOW_COPY_AND_ASSIGN(WaylandWindow);
 };